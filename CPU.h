@@ -1,40 +1,189 @@
 #pragma once
 #include <cstdint>
-#include "memory.h"
+
+// Flag evaluation modes:
+//   default               F is computed by every ALU instruction.
+//   GB_LAZY_FLAGS         ALU instructions only record their operands; F is
+//                         built when something actually reads it (branches,
+//                         carry-in, PUSH AF, DAA, the tracer).
+//   GB_LAZY_FLAGS_VERIFY  lazy mode plus an eagerly computed shadow of F that
+//                         is compared with the lazy result after every
+//                         instruction. tests/test_lazy_flags.cpp runs it
+//                         over every handler that reads or writes F.
+#if defined(GB_LAZY_FLAGS_VERIFY) && !defined(GB_LAZY_FLAGS)
+#define GB_LAZY_FLAGS
+#endif
+#if !defined(GB_LAZY_FLAGS) || defined(GB_LAZY_FLAGS_VERIFY)
+#define GB_EAGER_FLAGS
+#endif
+
+// Last flag-producing operation. With anything but FLAGS_KNOWN pending, F
+// holds only the bits that were already fixed when the op was recorded
+// (constant flags and flags the op leaves untouched).
+enum FlagOp : uint8_t {
+    FLAGS_KNOWN,    // F is complete
+    FLAGS_ADD,      // ADD/ADC: Z H C from flag_a + flag_b + flag_carry
+    FLAGS_SUB,      // SUB/SBC/CP: Z H C from flag_a - flag_b - flag_carry
+    FLAGS_ZERO,     // only Z, from flag_result
+    FLAGS_INC,      // Z H from flag_result
+    FLAGS_DEC,      // Z H from flag_result
+};
+
 struct CPU {
-    uint8_t A, B, C, D, E, F, H, L;
+    uint8_t A = 0, B = 0, C = 0, D = 0, E = 0, F = 0, H = 0, L = 0;
     uint16_t PC = 0x00, STACK_P = 0;
-    int clock_cycles;
+    int clock_cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t halt_cycles_skipped = 0;   // HALT time jumped over rather than stepped
     bool IME = false;
     bool IME_Pending = false;
     bool halted = false;
-    bool pc_modified = false;
     bool halt_bug = false;
-    bool justExecutedEI = false;
     uint8_t last_opcode = 0x00;
 
-    void setAF(uint16_t val) { A = val >> 8; F = val & 0xF0; }
+#ifdef GB_LAZY_FLAGS
+    uint8_t flag_op = FLAGS_KNOWN;
+    uint8_t flag_a = 0, flag_b = 0, flag_carry = 0;
+    int flag_result = 0;
+#endif
+#ifdef GB_LAZY_FLAGS_VERIFY
+    uint8_t F_eager = 0;
+#endif
+
+    void setAF(uint16_t val) { A = val >> 8; setF(val & 0xF0); }
     void setBC(uint16_t val) { B = val >> 8; C = val & 0xFF; }
     void setDE(uint16_t val) { D = val >> 8; E = val & 0xFF; }
     void setHL(uint16_t val) { H = val >> 8; L = val & 0xFF; }
 
-    uint16_t getAF() { return (A << 8) | F; }
+    uint16_t getAF() { return (A << 8) | getF(); }
     uint16_t getBC() { return (B << 8) | C; }
     uint16_t getDE() { return (D << 8) | E; }
     uint16_t getHL() { return (H << 8) | L; }
 
-    void setFlagZ(bool condition) { F = condition ? (F | 0x80) : (F & ~0x80); }
-    void setFlagN(bool condition) { F = condition ? (F | 0x40) : (F & ~0x40); }
-    void setFlagH(bool condition) { F = condition ? (F | 0x20) : (F & ~0x20); }
-    void setFlagC(bool condition) { F = condition ? (F | 0x10) : (F & ~0x10); }
+    // ---------------- flags ----------------
+
+    // F with any pending lazy op folded in, leaving the lazy state alone
+    uint8_t peekF() const {
+#ifdef GB_LAZY_FLAGS
+        uint8_t z = (flag_result & 0xFF) == 0 ? 0x80 : 0;
+        switch (flag_op) {
+        case FLAGS_ADD:
+            return F | z | (((flag_a & 0xF) + (flag_b & 0xF) + flag_carry) > 0xF ? 0x20 : 0) | (flag_result > 0xFF ? 0x10 : 0);
+        case FLAGS_SUB:
+            return F | z | (((flag_a & 0xF) - (flag_b & 0xF) - flag_carry) < 0 ? 0x20 : 0) | (flag_result < 0 ? 0x10 : 0);
+        case FLAGS_ZERO:
+            return F | z;
+        case FLAGS_INC:
+            return F | z | ((flag_result & 0x0F) == 0x00 ? 0x20 : 0);
+        case FLAGS_DEC:
+            return F | z | ((flag_result & 0x0F) == 0x0F ? 0x20 : 0);
+        }
+#endif
+        return F;
+    }
+
+    uint8_t getF() {
+#ifdef GB_LAZY_FLAGS
+        F = peekF();
+        flag_op = FLAGS_KNOWN;
+#endif
+        return F;
+    }
+
+    void setF(uint8_t val) {
+        F = val;
+#ifdef GB_LAZY_FLAGS
+        flag_op = FLAGS_KNOWN;
+#endif
+#ifdef GB_LAZY_FLAGS_VERIFY
+        F_eager = val;
+#endif
+    }
+
+    // Single-flag reads used by branches and carry-in; these never force
+    // the rest of F to be built.
+    bool getFlagZ() const {
+#ifdef GB_LAZY_FLAGS
+        if (flag_op != FLAGS_KNOWN) return (flag_result & 0xFF) == 0;
+#endif
+        return (F & 0x80) != 0;
+    }
 
-    bool getFlagC() { return (F & 0x10) != 0; }
+    bool getFlagC() const {
+#ifdef GB_LAZY_FLAGS
+        if (flag_op == FLAGS_ADD) return flag_result > 0xFF;
+        if (flag_op == FLAGS_SUB) return flag_result < 0;
+#endif
+        return (F & 0x10) != 0;
+    }
+
+    void setFlagZ(bool condition) { uint8_t f = getF(); setF(condition ? (f | 0x80) : (f & ~0x80)); }
+    void setFlagN(bool condition) { uint8_t f = getF(); setF(condition ? (f | 0x40) : (f & ~0x40)); }
+    void setFlagH(bool condition) { uint8_t f = getF(); setF(condition ? (f | 0x20) : (f & ~0x20)); }
+    void setFlagC(bool condition) { uint8_t f = getF(); setF(condition ? (f | 0x10) : (f & ~0x10)); }
+
+    // Flag producers for the ALU. `result` is the untruncated result for
+    // ADD/SUB (so the carry is still visible) and the 8-bit result otherwise.
+    void flagsAdd(uint8_t a, uint8_t b, int carry, int result) {
+#ifdef GB_LAZY_FLAGS
+        recordFlags(FLAGS_ADD, 0x00, result);
+        flag_a = a; flag_b = b; flag_carry = carry;
+#endif
+#ifdef GB_EAGER_FLAGS
+        eagerF() = ((result & 0xFF) == 0 ? 0x80 : 0) | (((a & 0xF) + (b & 0xF) + carry) > 0xF ? 0x20 : 0) | (result > 0xFF ? 0x10 : 0);
+#endif
+    }
+
+    void flagsSub(uint8_t a, uint8_t b, int carry, int result) {
+#ifdef GB_LAZY_FLAGS
+        recordFlags(FLAGS_SUB, 0x40, result);
+        flag_a = a; flag_b = b; flag_carry = carry;
+#endif
+#ifdef GB_EAGER_FLAGS
+        eagerF() = ((result & 0xFF) == 0 ? 0x80 : 0) | 0x40 | (((a & 0xF) - (b & 0xF) - carry) < 0 ? 0x20 : 0) | (result < 0 ? 0x10 : 0);
+#endif
+    }
+
+    // Z from `result`, N H C given by `others`
+    void flagsZero(uint8_t result, uint8_t others) {
+#ifdef GB_LAZY_FLAGS
+        recordFlags(FLAGS_ZERO, others, result);
+#endif
+#ifdef GB_EAGER_FLAGS
+        eagerF() = (result == 0 ? 0x80 : 0) | others;
+#endif
+    }
+
+    // INC/DEC leave C alone
+    void flagsInc(uint8_t result) {
+#ifdef GB_LAZY_FLAGS
+        recordFlags(FLAGS_INC, getFlagC() ? 0x10 : 0x00, result);
+#endif
+#ifdef GB_EAGER_FLAGS
+        eagerF() = (eagerF() & 0x10) | (result == 0 ? 0x80 : 0) | ((result & 0x0F) == 0x00 ? 0x20 : 0);
+#endif
+    }
+
+    void flagsDec(uint8_t result) {
+#ifdef GB_LAZY_FLAGS
+        recordFlags(FLAGS_DEC, (getFlagC() ? 0x10 : 0x00) | 0x40, result);
+#endif
+#ifdef GB_EAGER_FLAGS
+        eagerF() = (eagerF() & 0x10) | 0x40 | (result == 0 ? 0x80 : 0) | ((result & 0x0F) == 0x0F ? 0x20 : 0);
+#endif
+    }
 
-    void request_interrupt(int id) {
-        uint8_t iflag = memory.read(0xFF0F);
-        iflag |= (1 << id);
-        memory.write(0xFF0F, iflag);
+private:
+#ifdef GB_LAZY_FLAGS
+    void recordFlags(uint8_t op, uint8_t fixed, int result) {
+        F = fixed;
+        flag_op = op;
+        flag_result = result;
     }
-    
+#endif
+#ifdef GB_LAZY_FLAGS_VERIFY
+    uint8_t& eagerF() { return F_eager; }
+#elif !defined(GB_LAZY_FLAGS)
+    uint8_t& eagerF() { return F; }
+#endif
 };
-extern CPU cpu;
\ No newline at end of file
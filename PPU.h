@@ -1,107 +1,188 @@
 #pragma once
 #include <stdio.h>
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
+#include <memory>
+#include "line_renderer.h"
 #include "memory.h"
-#include "cpu.h"
-#include "video.h"
+#include "render_thread.h"
 
-
-uint8_t framebuffer[144][160];
-extern CPU cpu;
-extern Memory memory;
+// One frame of XRGB8888 pixels
+typedef uint32_t Framebuffer[144][160];
 
 struct PPU {
+    Memory& memory;
+    Framebuffer& framebuffer;
+    LineRenderer renderer{ memory.vram };
+
+    // Set while lines are drawn on a thread of their own (see
+    // start_render_thread); otherwise `renderer` draws them as they end
+    std::unique_ptr<RenderThread> render_thread;
+
+    // Where lines are drawn: line y starts at target + y * target_pitch.
+    // The machine's framebuffer unless the frontend points it somewhere
+    // else, such as a locked texture (see set_target).
+    uint32_t* target = &framebuffer[0][0];
+    int target_pitch = 160;     // in pixels
+
+    // Called once per frame at VBlank with the finished frame (with a render
+    // thread, at the next VBlank, once the thread has drawn it). The PPU
+    // itself knows nothing about the display; the frontend installs this,
+    // and may move the target from it for the next frame.
+    void (*frame_hook)(void* context, const uint32_t* pixels, int pitch) = nullptr;
+    void* frame_context = nullptr;
+
     int ppu_clock = 0;
     int scanline = 0;
     int mode = 0;
     bool  vblank_triggered = false;
     bool lcd_enabled = false;
 
-    
+    // The STAT interrupt line: its conditions ORed under their enable bits.
+    // The interrupt is requested when it goes high, not while it stays high.
+    bool stat_line = false;
+    int stat_inputs = -1;   // mode, enables, LY and LYC it was last computed from
 
-    void update_registers_from_memory() {
-         
-        uint8_t stat = memory.read(0xFF41);
-        stat = (stat & 0xFC) | (mode & 0x03);  // bits 0-1: mode
-        
+    // This line's sprites from the mode 2 OAM scan, in priority order
+    uint8_t line_sprites[10];
+    int line_sprite_count = 0;
+    bool oam_scanned = false;
 
-        // --- 2. LYC=LY flag ---
-        uint8_t ly = memory.read(0xFF44);
-        uint8_t lyc = memory.read(0xFF45);
+    PPU(Memory& memory, Framebuffer& framebuffer) : memory(memory), framebuffer(framebuffer) {}
+    PPU(const PPU&) = delete;
+    PPU& operator=(const PPU&) = delete;
 
-        if (ly == lyc) {
-            stat |= 0x04;  // bit 2: coincidence flag
-            if (stat & 0x40) {  // bit 6: coincidence interrupt enable
-                memory.write(0xFF0F, memory.read(0xFF0F) | 0x02);  // STAT interrupt
-            }
-        }
-        else {
-            stat &= ~0x04;  // clear coincidence flag
-        }
-       
-
-        // 3. Mode-based STAT interrupts (bits 3-5)
-        switch (mode) {
-        case 0:  // HBlank
-            if (stat & 0x08) memory.write(0xFF0F, memory.read(0xFF0F) | 0x02);
-            break;
-        case 1:  // VBlank
-            if (stat & 0x10) memory.write(0xFF0F, memory.read(0xFF0F) | 0x02);
-            break;
-        case 2:  // OAM
-            if (stat & 0x20) memory.write(0xFF0F, memory.read(0xFF0F) | 0x02);
-            break;
-        }
+    // Draws the following lines to `pixels`, `pitch` pixels apart
+    void set_target(uint32_t* pixels, int pitch) {
+        target = pixels;
+        target_pitch = pitch;
+    }
 
-        // Final writeback of updated STAT
-        memory.write(0xFF41, stat);
-       
+    // Draws the following lines on a thread of their own while emulation
+    // goes on, a frame behind it: the frame hook is called for a frame at
+    // the following VBlank. Frames come out the same as without it.
+    void start_render_thread() {
+        if (!render_thread) render_thread.reset(new RenderThread(memory));
     }
-    
 
-   
+    // Back to drawing on the calling thread, once the lines handed over and
+    // those recorded since have been drawn (and a finished frame delivered)
+    void stop_render_thread() {
+        if (!render_thread) return;
+        hand_over(false);
+        render_thread->wait();
+        render_thread.reset();
+    }
+
+    RenderStats render_stats() {
+        return render_thread ? render_thread->stats() : renderer.stats();
+    }
+
+    // Brings STAT's mode and LYC=LY bits and the STAT line up to date. Does
+    // nothing unless the mode, LY, LYC or an enable bit changed since last time.
+    void update_stat() {
+        const uint8_t* io = &memory.data[0xFF00];
+        uint8_t stat = io[0x41], ly = io[0x44], lyc = io[0x45];
+        int inputs = mode | (stat & 0x78) | ly << 8 | lyc << 16;
+        if (inputs == stat_inputs) return;
+        stat_inputs = inputs;
+
+        bool coincidence = ly == lyc;
+        memory.set_io(0xFF41, (stat & 0xF8) | (coincidence ? 0x04 : 0x00) | mode);
+        bool line = (coincidence && (stat & 0x40))    // bit 6: LYC=LY
+            || (mode == 0 && (stat & 0x08))             // bit 3: HBlank
+            || (mode == 1 && (stat & 0x10))             // bit 4: VBlank
+            || (mode == 2 && (stat & 0x20));            // bit 5: OAM
+        if (line && !stat_line) memory.write(0xFF0F, io[0x0F] | 0x02);
+        stat_line = line;
+    }
 
+    // T-cycles until step() next changes mode or LY
+    int cycles_until_mode_change() const {
+        if (scanline >= 144 || ppu_clock >= 252) return 456 - ppu_clock;
+        if (ppu_clock < 80) return 80 - ppu_clock;
+        return 252 - ppu_clock;
+    }
 
+    // T-cycles until step() next reads VRAM or OAM: the OAM scan of a
+    // visible line or the end of a line, where it is drawn
+    int cycles_until_draw() const {
+        if (scanline < 144 && !oam_scanned) return std::max(80 - ppu_clock, 0);
+        return 456 - ppu_clock;
+    }
 
+    // T-cycles until cycle `clock` of line `line` next comes round
+    int cycles_until(int line, int clock) const {
+        int cycles = ((line - scanline + 154) % 154) * 456 + clock - ppu_clock;
+        return cycles > 0 ? cycles : cycles + 154 * 456;
+    }
+
+    // T-cycles until the PPU next has to be stepped: the end of the frame
+    // (VBlank interrupt and frame hook) or the next point where an enabled
+    // STAT condition comes true. Nothing else it does can be seen without
+    // reading or writing its state, and those accesses catch it up first
+    // (see Machine). While `watched`, the CPU is reading LY or STAT and every
+    // mode or line change counts. With the LCD off nothing ever happens.
+    int cycles_until_event(bool watched) const {
+        const uint8_t* io = &memory.data[0xFF00];
+        if (!(io[0x40] & 0x80)) return 1 << 30;
+        if (watched) return cycles_until_mode_change();
+
+        uint8_t stat = io[0x41], lyc = io[0x45];
+        int next_visible = scanline + 1 < 144 ? scanline + 1 : 0;
+        int cycles = cycles_until(145, 0);
+        if (stat & 0x08) {      // HBlank
+            int hblank = scanline < 144 && ppu_clock < 252 ? 252 - ppu_clock : cycles_until(next_visible, 252);
+            cycles = std::min(cycles, hblank);
+        }
+        if (stat & 0x10) cycles = std::min(cycles, cycles_until(144, 0));             // VBlank
+        if (stat & 0x20) cycles = std::min(cycles, cycles_until(next_visible, 0));    // OAM
+        // LY takes a line's number when that line ends
+        if ((stat & 0x40) && lyc < 154) cycles = std::min(cycles, cycles_until((lyc + 1) % 154, 0));
+        return cycles;
+    }
+
+    // Catches up by `cycles`, one mode at a time so that STAT sees every
+    // mode and line change on the way
     void step(int cycles) {
-        lcd_enabled = (memory.read(0xFF40) & 0x80) != 0;
+        bool was_enabled = lcd_enabled;
+        lcd_enabled = (memory.data[0xFF40] & 0x80) != 0;
 
         if (!lcd_enabled) {
+            if (was_enabled && render_thread) hand_over(false);
             // Optional: reset LY to 0 when LCD is off
-            memory.write(0xFF44, 0x00);
+            memory.set_io(0xFF44, 0x00);
+            memory.set_io(0xFF41, memory.data[0xFF41] & 0xFC);  // STAT mode = 0 (HBlank)
             ppu_clock = 0;
             scanline = 0;
+            mode = 0;
+            oam_scanned = false;
+            stat_line = false;
+            stat_inputs = -1;
             return;
         }
-        ppu_clock += cycles;
-        
-
-        if (scanline < 144) {
-            if (ppu_clock < 80)
-                mode = 2; // OAM Scan
-            else if (ppu_clock < 252)
-                mode = 3; // Transfer
-            else
-                mode = 0; // HBlank
-        }
-        else {
-            mode = 1; // VBlank
-        }                   // HBlank
-
-        update_registers_from_memory();
+        do {
+            int run = std::min(cycles, cycles_until_mode_change());
+            cycles -= run;
+            advance(run);
+        } while (cycles > 0);
+#ifdef GB_TRACE
+        printf("ppu_clock is %d\n", ppu_clock);
+#endif
+    }
 
-      
+    // Moves on by at most one mode
+    void advance(int cycles) {
+        ppu_clock += cycles;
+        if (scanline < 144 && ppu_clock >= 80 && !oam_scanned) scan_oam();
 
         if (ppu_clock >= 456) {
             ppu_clock -= 456;
             
-            memory.write(0xFF44, static_cast<uint8_t>(scanline));
+            memory.set_io(0xFF44, static_cast<uint8_t>(scanline));
 
-            if (scanline < 144) {
-                render_scanline();
-                render_window();   // 
-                render_sprites();     // 
-            }
+            if (scanline < 144) draw_line();
           
 
             if (!vblank_triggered && scanline == 144) {
@@ -111,14 +192,12 @@ struct PPU {
                 memory.write(0xFF0F, iflag);
 
                 // 2. Trigger rendering logic (optional but recommended)
-                render_frame(framebuffer);
-                SDL_Delay(100);
-                // 
-
-
+                if (render_thread) hand_over(true);
+                else if (frame_hook) frame_hook(frame_context, target, target_pitch);
                 vblank_triggered = true;
             }
             scanline++;
+            oam_scanned = false;
 
             if (scanline > 153) {
                 scanline = 0;
@@ -127,111 +206,71 @@ struct PPU {
 
            
         }
-        printf("ppu_clock is %d\n", ppu_clock);
-    }
 
-    void render_scanline() {
-        uint8_t scx = memory.read(0xFF43);
-        uint8_t scy = memory.read(0xFF42);
-        uint8_t bgp = memory.read(0xFF47);
-        uint8_t lcdc = memory.read(0xFF40);
-        if (!(lcdc & 0x01)) return;
-
-        uint16_t tile_map = (lcdc & 0x08) ? 0x9C00 : 0x9800;
-        uint16_t tile_data = (lcdc & 0x10) ? 0x8000 : 0x8800;
-        bool signed_index = !(lcdc & 0x10);
-        printf("LCDC = 0x%02X | Tile data base = 0x%04X\n", lcdc, (lcdc & 0x10) ? 0x8000 : 0x8800);
-
-        for (int x = 0; x < 160; ++x) {
-            uint8_t pixel_x = (x + scx) & 0xFF;
-            uint8_t pixel_y = (scanline + scy) & 0xFF;
-
-            uint8_t tile_col = pixel_x / 8;
-            uint8_t tile_row = pixel_y / 8;
-            uint16_t tile_index_addr = tile_map + tile_row * 32 + tile_col;
-            int tile_index = memory.read(tile_index_addr);
-            if (signed_index) tile_index = (int8_t)tile_index;
-
-            uint16_t tile_addr = tile_data + tile_index * 16;
-            uint8_t line = pixel_y % 8;
-            uint8_t byte1 = memory.read(tile_addr + line * 2);
-            uint8_t byte2 = memory.read(tile_addr + line * 2 + 1);
-            int bit = 7 - (pixel_x % 8);
-            uint8_t color_num = ((byte2 >> bit) & 1) << 1 | ((byte1 >> bit) & 1);
-            uint8_t color = (bgp >> (color_num * 2)) & 0x03;
-
-            framebuffer[scanline][x] = color;
-            printf("rendered scanline - %d\n", scanline);
-            printf("color value is 0x%02X\n", color);
+        // Mode and STAT after any line change, so a new line shows mode 2
+        // (or 1) and its LYC=LY result from its first cycle
+        if (scanline < 144) {
+            if (ppu_clock < 80)
+                mode = 2; // OAM Scan
+            else if (ppu_clock < 252)
+                mode = 3; // Transfer
+            else
+                mode = 0; // HBlank
+        }
+        else {
+            mode = 1; // VBlank
         }
+        update_stat();
     }
 
-    void render_window() {
-        uint8_t lcdc = memory.read(0xFF40);
-        if (!(lcdc & 0x20)) return;
-
-        uint8_t wx = memory.read(0xFF4B) - 7;
-        uint8_t wy = memory.read(0xFF4A);
-        uint8_t bgp = memory.read(0xFF47);
-        if (scanline < wy) return;
-
-        uint16_t tile_map = (lcdc & 0x40) ? 0x9C00 : 0x9800;
-        uint16_t tile_data = (lcdc & 0x10) ? 0x8000 : 0x8800;
-        bool signed_index = !(lcdc & 0x10);
-        uint8_t win_y = scanline - wy;
-
-        for (int x = wx; x < 160; ++x) {
-            uint8_t win_x = x - wx;
-            uint8_t tile_col = win_x / 8;
-            uint8_t tile_row = win_y / 8;
-
-            uint16_t tile_index_addr = tile_map + tile_row * 32 + tile_col;
-            int tile_index = memory.read(tile_index_addr);
-            if (signed_index) tile_index = (int8_t)tile_index;
-
-            uint16_t tile_addr = tile_data + tile_index * 16;
-            uint8_t line = win_y % 8;
-            uint8_t byte1 = memory.read(tile_addr + line * 2);
-            uint8_t byte2 = memory.read(tile_addr + line * 2 + 1);
-
-            int bit = 7 - (win_x % 8);
-            uint8_t color_num = ((byte2 >> bit) & 1) << 1 | ((byte1 >> bit) & 1);
-            uint8_t color = (bgp >> (color_num * 2)) & 0x03;
+    // The line just finished, with the registers and sprites it is drawn
+    // from. The PPU reads VRAM, OAM and its registers straight from the
+    // backing store, as the hardware does, rather than through the CPU's bus.
+    void draw_line() {
+        const uint8_t* mem = memory.data.data();
+        LineState line;
+        line.ly = (uint8_t)scanline;
+        line.lcdc = mem[0xFF40];
+        line.scy = mem[0xFF42];
+        line.scx = mem[0xFF43];
+        line.wy = mem[0xFF4A];
+        line.wx = mem[0xFF4B];
+        for (int i = 0; i < 3; i++) line.palettes[i] = mem[0xFF47 + i];
+        line.sprite_count = (uint8_t)line_sprite_count;
+        for (int k = 0; k < line_sprite_count; k++) memcpy(line.sprites[k], mem + 0xFE00 + line_sprites[k] * 4, 4);
+        line.vram_writes = 0;
+
+        if (render_thread) render_thread->record(line);
+        else renderer.draw(line, target + scanline * target_pitch);
+    }
 
-            framebuffer[scanline][x] = color;
-        }
+    // Waits for the render thread to draw the lines handed over last,
+    // delivers them if they were a frame, and hands over the lines recorded
+    // since, to be drawn into the current target
+    void hand_over(bool frame_done) {
+        const RenderThread::Batch* drawn = render_thread->wait();
+        if (drawn && drawn->frame_done && frame_hook) frame_hook(frame_context, drawn->target, drawn->pitch);
+        render_thread->submit(target, target_pitch, frame_done);
     }
 
-    void render_sprites() {
-        uint8_t lcdc = memory.read(0xFF40);
-        bool use_8x16 = lcdc & 0x04;
-
-        for (int i = 0; i < 40; ++i) {
-            uint8_t y = memory.read(0xFE00 + i * 4) - 16;
-            uint8_t x = memory.read(0xFE00 + i * 4 + 1) - 8;
-            uint8_t tile_index = memory.read(0xFE00 + i * 4 + 2);
-            uint8_t attr = memory.read(0xFE00 + i * 4 + 3);
-
-            if (scanline < y || scanline >= y + (use_8x16 ? 16 : 8)) continue;
-
-            int sprite_line = scanline - y;
-            if (attr & 0x40) sprite_line = (use_8x16 ? 15 : 7) - sprite_line;
-            uint16_t tile_addr = 0x8000 + tile_index * 16 + sprite_line * 2;
-
-            uint8_t byte1 = memory.read(tile_addr);
-            uint8_t byte2 = memory.read(tile_addr + 1);
-
-            for (int j = 0; j < 8; ++j) {
-                int pixel_x = x + ((attr & 0x20) ? j : (7 - j));
-                if (pixel_x < 0 || pixel_x >= 160) continue;
-                uint8_t bit0 = (byte1 >> j) & 1;
-                uint8_t bit1 = (byte2 >> j) & 1;
-                uint8_t color_id = (bit1 << 1) | bit0;
-                if (color_id == 0) continue;
-                framebuffer[scanline][pixel_x] = 4 + color_id;
-            }
+    // Mode 2: picks the first 10 OAM entries (in OAM order) whose Y puts
+    // them on this line, as the hardware does; the rest are dropped. Entries
+    // off the left or right edge still count. They are then put in drawing
+    // priority order: smaller X first, OAM order among equal X.
+    void scan_oam() {
+        const uint8_t* mem = memory.data.data();
+        const uint8_t* oam = mem + 0xFE00;
+        int height = (mem[0xFF40] & 0x04) ? 16 : 8;
+        line_sprite_count = 0;
+        for (uint64_t candidates = memory.sprite_lines[scanline]; candidates && line_sprite_count < 10; candidates &= candidates - 1) {
+            int entry = Memory::lowest_bit(candidates);
+            if (scanline + 16 - oam[entry * 4] >= height) continue;
+
+            int k = line_sprite_count++;
+            for (; k > 0 && oam[line_sprites[k - 1] * 4 + 1] > oam[entry * 4 + 1]; k--)
+                line_sprites[k] = line_sprites[k - 1];
+            line_sprites[k] = entry;
         }
+        oam_scanned = true;
     }
 };
-
-extern PPU ppu;
@@ -0,0 +1,395 @@
+#pragma once
+#include <stdio.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "opcode_table.h"
+#include "interpreter.h"
+
+// Decoded basic-block cache (GB_BLOCK_CACHE).
+//
+// A block is a straight-line run of instructions starting at some PC and
+// ending at the first branch, call, return, RST, HALT/STOP or illegal opcode.
+// It is decoded once into an array of micro-ops holding the resolved handler
+// (CB opcodes point straight at their CB handler), then replayed every time
+// execution reaches that PC again. Handlers still fetch their own immediates,
+// so replay behaves exactly like the plain interpreter.
+//
+// Every byte covered by a block is counted in memory.code_map. Writing to such
+// a byte, or calling memory.invalidate_code() for a bank switch, drops each
+// block overlapping the range; the next visit decodes the new code.
+
+constexpr int BLOCK_MAX_BYTES = 64;
+
+struct Block;
+struct BlockCore;
+
+// A recognised loop idiom run as one superinstruction: performs as many whole
+// iterations as fit in `window` T-cycles, leaving CPU state exactly as the
+// individual instructions would, or returns false to have the block replayed
+// normally.
+typedef bool (BlockCore::*FusedLoop)(Block* block, int window);
+
+struct MicroOp {
+    Interpreter::OpHandler handler;
+    uint8_t arg;     // opcode passed to the handler (the CB byte for CB ops)
+    uint8_t skip;    // opcode bytes consumed before the handler runs: 1, or 2 for CB
+};
+
+struct Block {
+    uint16_t start;
+    uint16_t length;     // bytes of guest code covered
+    bool valid = true;
+    uint32_t exec_count = 0;
+    std::vector<MicroOp> ops;
+    FusedLoop fused = nullptr;   // the block is a whole loop with a fused form
+    void (*jit)() = nullptr;     // compiled code, filled in by the JIT (GB_JIT)
+    bool jit_tried = false;
+};
+
+static inline bool ends_block(Op op) {
+    switch (op) {
+    case Op::JR: case Op::JP: case Op::CALL: case Op::RET: case Op::RETI: case Op::RST:
+    case Op::HALT: case Op::STOP: case Op::INVALID:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Iterations of a counted loop that fit in `window`, given the cost of a
+// taken and of the final (falling through) iteration
+static inline int fused_iterations(int remaining, int taken, int last, int window, bool& exits) {
+    exits = (remaining - 1) * taken + last <= window;
+    return exits ? remaining : window / taken;
+}
+
+struct BlockCache {
+    Memory& memory;
+    Block* by_pc[0x10000] = {};
+    std::vector<Block*> retired;     // invalidated, freed at the next lookup
+
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t invalidations = 0;
+    uint64_t fused_runs = 0;
+    uint64_t idle_skips = 0;        // idle loop runs that skipped ahead
+    uint64_t idle_cycles = 0;       // T-cycles of idle loop iterations skipped
+
+    explicit BlockCache(Memory& memory) : memory(memory) {}
+    BlockCache(const BlockCache&) = delete;
+    BlockCache& operator=(const BlockCache&) = delete;
+
+    ~BlockCache() {
+        for (Block* block : retired) delete block;
+        for (Block* block : by_pc) delete block;
+    }
+
+    // Returns the block starting at pc, or nullptr on a miss. Must not be
+    // called while a block is being replayed.
+    Block* find(uint16_t pc) {
+        if (!retired.empty()) {
+            for (Block* block : retired) delete block;
+            retired.clear();
+        }
+        Block* block = by_pc[pc];
+        if (block) hits++;
+        else misses++;
+        return block;
+    }
+
+    void insert(Block* block) {
+        by_pc[block->start] = block;
+        for (int i = 0; i < block->length; i++) memory.add_code((uint16_t)(block->start + i));
+    }
+
+    // Drops every block that covers any byte in [first, last]
+    void invalidate(uint16_t first, uint16_t last) {
+        int from = first - (BLOCK_MAX_BYTES - 1);
+        if (from < 0) from = 0;
+        for (int pc = from; pc <= last; pc++) {
+            Block* block = by_pc[pc];
+            if (!block || pc + block->length <= first) continue;
+            for (int i = 0; i < block->length; i++) memory.remove_code((uint16_t)(pc + i));
+            block->valid = false;
+            by_pc[pc] = nullptr;
+            retired.push_back(block);
+            invalidations++;
+        }
+    }
+
+    void clear() { invalidate(0x0000, 0xFFFF); }
+};
+
+// The interpreter plus a block cache. Installs itself as the memory's code
+// write hook so guest writes over decoded code reach the cache.
+struct BlockCore : Interpreter {
+    BlockCache block_cache{ memory };
+
+    BlockCore() {
+        memory.code_write_hook = code_write_hook;
+        memory.code_write_context = this;
+    }
+
+    static void code_write_hook(void* context, uint16_t first, uint16_t last) {
+        static_cast<BlockCore*>(context)->block_cache.invalidate(first, last);
+    }
+
+    // Returns the block starting at pc, decoding it on a miss
+    Block* lookup_block(uint16_t pc) {
+        Block* block = block_cache.find(pc);
+        if (!block) {
+            block = decode_block(pc);
+            block_cache.insert(block);
+        }
+        return block;
+    }
+
+    // ---------------- fused loops ----------------
+
+    // Loops are only fused when they start a block and end in the JR back to it,
+    // so a fused run always starts and ends on an instruction boundary of that
+    // loop. The caller sizes `window` to end at the next scheduled event, so no
+    // PPU mode or line change, interrupt or end of run can fall inside it;
+    // advancing the clock once by the total is then the same as running the
+    // instructions one at a time.
+
+    // Bulk accesses go through Memory::direct_read/direct_write, which only
+    // hand out plain, code-free RAM, so they need neither handlers nor
+    // invalidation.
+
+    // LD (HL+),A / LD (HL-),A ; DEC C / DEC B ; JR NZ,loop
+    template <uint8_t STORE, uint8_t DEC> bool fused_fill(Block* block, int window) {
+        constexpr int counter = r8_dst(DEC);
+        constexpr int taken = unprefixed_table[STORE].cycles[0] + unprefixed_table[DEC].cycles[0] + unprefixed_table[0x20].cycles[0];
+        constexpr int last = taken - unprefixed_table[0x20].cycles[0] + unprefixed_table[0x20].cycles[1];
+
+        int remaining = get_r8<counter>() ? get_r8<counter>() : 256;
+        bool exits;
+        int n = fused_iterations(remaining, taken, last, window, exits);
+        if (n == 0) return false;
+
+        int hl = cpu.getHL();
+        int first = STORE == 0x22 ? hl : hl - (n - 1);
+        uint8_t* dst = first < 0 ? nullptr : memory.direct_write(first, n);
+        if (!dst) return false;
+
+        memset(dst, cpu.A, n);
+        cpu.setHL(STORE == 0x22 ? hl + n : hl - n);
+        set_r8<counter>(get_r8<counter>() - n);
+        cpu.flagsDec(get_r8<counter>());
+        cpu.PC = exits ? block->start + block->length : block->start;
+        cpu.clock_cycles = n * taken - (exits ? taken - last : 0);
+        cpu.instructions += 3 * n;
+        return true;
+    }
+
+    // LD A,(DE) ; LD (HL+),A ; INC DE ; DEC C/B ; JR NZ,loop   (LOAD = 0x1A)
+    // LD A,(HL+) ; LD (DE),A ; INC DE ; DEC C/B ; JR NZ,loop   (LOAD = 0x2A)
+    template <uint8_t LOAD, uint8_t DEC> bool fused_copy(Block* block, int window) {
+        constexpr uint8_t STORE = LOAD == 0x1A ? 0x22 : 0x12;
+        constexpr int counter = r8_dst(DEC);
+        constexpr int taken = unprefixed_table[LOAD].cycles[0] + unprefixed_table[STORE].cycles[0] + unprefixed_table[0x13].cycles[0] +
+            unprefixed_table[DEC].cycles[0] + unprefixed_table[0x20].cycles[0];
+        constexpr int last = taken - unprefixed_table[0x20].cycles[0] + unprefixed_table[0x20].cycles[1];
+
+        int remaining = get_r8<counter>() ? get_r8<counter>() : 256;
+        bool exits;
+        int n = fused_iterations(remaining, taken, last, window, exits);
+        if (n == 0) return false;
+
+        uint16_t src = LOAD == 0x1A ? cpu.getDE() : cpu.getHL();
+        uint16_t dst = LOAD == 0x1A ? cpu.getHL() : cpu.getDE();
+        const uint8_t* from = memory.direct_read(src, n);
+        uint8_t* to = memory.direct_write(dst, n);
+        if (!from || !to) return false;
+
+        // Byte by byte, so overlapping ranges behave like the guest loop
+        for (int i = 0; i < n; i++) to[i] = from[i];
+        cpu.A = from[n - 1];
+        cpu.setHL(cpu.getHL() + n);
+        cpu.setDE(cpu.getDE() + n);
+        set_r8<counter>(get_r8<counter>() - n);
+        cpu.flagsDec(get_r8<counter>());
+        cpu.PC = exits ? block->start + block->length : block->start;
+        cpu.clock_cycles = n * taken - (exits ? taken - last : 0);
+        cpu.instructions += 5 * n;
+        return true;
+    }
+
+    // Idle loop: load A from memory, test it, branch back while unchanged.
+    // Between events memory only changes through CPU writes (the PPU touches
+    // its registers and IF only when synced), and the loop writes nothing, so
+    // every iteration inside the window repeats the first one exactly. One
+    // iteration is run for real to set A and the flags and to see whether it
+    // leaves the loop; the rest are skipped. A load of LY or STAT brings the
+    // PPU's next event forward, so the window is measured again after it.
+    bool fused_idle(Block* block, int window) {
+        int taken = 0;
+        for (const MicroOp& op : block->ops)
+            taken += op.skip == 2 ? 8 : unprefixed_table[op.arg].cycles[0];
+        if (window < taken) return false;
+
+        for (const MicroOp& op : block->ops) {
+            cpu.PC += op.skip;
+            cpu.last_opcode = op.skip == 2 ? 0xCB : op.arg;
+            (this->*op.handler)(op.arg);
+        }
+        window = std::min(window, (int)scheduler.until_next());
+        int n = cpu.PC == block->start ? std::max(1, window / taken) : 1;
+        cpu.clock_cycles += (n - 1) * taken;
+        cpu.instructions += n * block->ops.size();
+        if (n > 1) {
+            block_cache.idle_skips++;
+            block_cache.idle_cycles += (uint64_t)(n - 1) * taken;
+        }
+        return true;
+    }
+
+    // Length of an idle-loop load of A (LDH A,(n) / LDH A,(C) / LD A,(a16) /
+    // LD A,(HL|BC|DE)), or 0
+    static int idle_load_length(uint8_t opcode) {
+        switch (opcode) {
+        case 0xF0: return 2;
+        case 0xFA: return 3;
+        case 0xF2: case 0x7E: case 0x0A: case 0x1A: return 1;
+        default: return 0;
+        }
+    }
+
+    // Length of an idle-loop test of A that only sets flags or masks A
+    // (CP d8 / AND d8 / AND A / OR A / BIT b,A), or 0
+    static int idle_test_length(const uint8_t* b) {
+        switch (b[0]) {
+        case 0xFE: case 0xE6: return 2;
+        case 0xA7: case 0xB7: return 1;
+        case 0xCB: return (b[1] & 0xC7) == 0x47 ? 2 : 0;
+        default: return 0;
+        }
+    }
+
+    FusedLoop match_fused_loop(uint16_t pc) {
+        if (pc > 0xFFF0) return nullptr;
+        uint8_t b[7];
+        for (int i = 0; i < 7; i++) b[i] = memory.read(pc + i);
+        bool dec_c = b[1] == 0x0D;
+
+        if ((b[0] == 0x22 || b[0] == 0x32) && (b[1] == 0x0D || b[1] == 0x05) && b[2] == 0x20 && b[3] == 0xFC) {
+            if (b[0] == 0x22) return dec_c ? &BlockCore::fused_fill<0x22, 0x0D> : &BlockCore::fused_fill<0x22, 0x05>;
+            return dec_c ? &BlockCore::fused_fill<0x32, 0x0D> : &BlockCore::fused_fill<0x32, 0x05>;
+        }
+        dec_c = b[3] == 0x0D;
+        if (((b[0] == 0x1A && b[1] == 0x22) || (b[0] == 0x2A && b[1] == 0x12)) && b[2] == 0x13 &&
+            (b[3] == 0x0D || b[3] == 0x05) && b[4] == 0x20 && b[5] == 0xFA) {
+            if (b[0] == 0x1A) return dec_c ? &BlockCore::fused_copy<0x1A, 0x0D> : &BlockCore::fused_copy<0x1A, 0x05>;
+            return dec_c ? &BlockCore::fused_copy<0x2A, 0x0D> : &BlockCore::fused_copy<0x2A, 0x05>;
+        }
+        int load = idle_load_length(b[0]);
+        int test = load ? idle_test_length(b + load) : 0;
+        int jr = load + test;
+        if (test && (b[jr] == 0x20 || b[jr] == 0x28) && b[jr + 1] == (uint8_t)-(jr + 2))
+            return &BlockCore::fused_idle;
+        return nullptr;
+    }
+
+    // Decodes the block starting at pc, up to its first control transfer
+    Block* decode_block(uint16_t pc) {
+        Block* block = new Block();
+        block->start = pc;
+        int addr = pc;
+        for (;;) {
+            uint8_t opcode = memory.read(addr);
+            const OpcodeInfo& info = unprefixed_table[opcode];
+            int length = opcode == 0xCB ? 2 : info.length;   // the table counts PREFIX as 1 byte
+            // Stop before running off the end of the address space or the
+            // block size limit. The first instruction is always within the
+            // limit, but at FFFE/FFFF it may not fit in the address space;
+            // the block is then empty and the caller steps the instruction.
+            if (addr + length > 0x10000 || (addr - pc + length > BLOCK_MAX_BYTES && !block->ops.empty()))
+                break;
+
+            MicroOp op;
+            if (opcode == 0xCB) {
+                uint8_t cb_opcode = memory.read(addr + 1);
+                op = { cb_handlers[cb_opcode], cb_opcode, 2 };
+            }
+            else {
+                op = { opcode_handlers[opcode], opcode, 1 };
+            }
+            block->ops.push_back(op);
+            addr += length;
+            if (ends_block(info.op)) break;
+        }
+        block->length = addr - pc;
+#ifndef GB_NO_FUSION
+        block->fused = match_fused_loop(pc);
+#endif
+        return block;
+    }
+
+    // Replays one block, advancing the scheduler after every instruction like
+    // cpu_run() does. Leaves early when an event comes due or the block itself
+    // was overwritten.
+    void run_block(Block* block) {
+        block->exec_count++;
+        for (const MicroOp& op : block->ops) {
+            cpu.clock_cycles = 0;
+#ifdef GB_TRACE
+            trace_instruction();
+#endif
+            bool enable_ime = cpu.IME_Pending;
+            cpu.PC += op.skip;
+            cpu.last_opcode = op.skip == 2 ? 0xCB : op.arg;
+            (this->*op.handler)(op.arg);
+#ifdef GB_LAZY_FLAGS_VERIFY
+            verify_flags();
+#endif
+            if (enable_ime && cpu.IME_Pending) {
+                cpu.IME = true;
+                cpu.IME_Pending = false;
+                scheduler.schedule_now(EVENT_INTERRUPT);
+            }
+            cpu.instructions++;
+            scheduler.now += cpu.clock_cycles;
+            if (!block->valid || scheduler.now >= scheduler.next) return;
+        }
+    }
+
+    // Runs a fused loop if the block has one and it can make progress before
+    // the next event. The end of the run is always scheduled, so the window
+    // is bounded by the budget.
+    bool run_fused(Block* block) {
+        if (!block->fused || cpu.IME_Pending) return false;
+        int window = (int)scheduler.until_next();
+        cpu.clock_cycles = 0;
+        if (!(this->*block->fused)(block, window)) return false;
+#ifdef GB_LAZY_FLAGS_VERIFY
+        verify_flags();
+#endif
+        block->exec_count++;
+        block_cache.fused_runs++;
+        scheduler.now += cpu.clock_cycles;
+        return true;
+    }
+
+    // cpu_run() through the block cache. HALT and interrupt entry happen in
+    // service_events(); the HALT bug and instructions that run past FFFF (an
+    // empty block) go through cpu_step().
+    int cpu_run_blocks(int budget) {
+        uint64_t start = begin_run(budget);
+        while (scheduler.now < scheduler.next || service_events()) {
+            if (cpu.halt_bug) {
+                scheduler.now += cpu_step();
+                continue;
+            }
+            Block* block = lookup_block(cpu.PC);
+            if (block->ops.empty()) {
+                scheduler.now += cpu_step();
+                continue;
+            }
+            if (!run_fused(block)) run_block(block);
+        }
+        return end_run(start);
+    }
+};
@@ -0,0 +1,195 @@
+#pragma once
+#include <stdio.h>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "rom_cache.h"
+#include "save_file.h"
+
+// Cartridge ROM and RAM plus the memory bank controller's registers.
+//
+// Memory points its 0000-7FFF and A000-BFFF pages straight into the ROM
+// image and the RAM at the banks computed here. A bank switch only changes
+// those banks and Memory repoints the affected page pointers; nothing is
+// copied. The ROM image is read only and may be shared with other instances
+// (see rom_cache.h); a bank that gets patched is copied first. RAM of
+// battery-backed carts lives in a mapped .sav file (see save_file.h).
+//
+// Supported: ROM only (with or without RAM), MBC1, MBC3 (no real-time clock:
+// the RTC registers read as FF) and MBC5. Anything else runs as ROM only.
+
+enum class Mbc : uint8_t { NONE, MBC1, MBC3, MBC5 };
+
+constexpr size_t ROM_BANK_SIZE = 0x4000;
+constexpr size_t RAM_BANK_SIZE = 0x2000;
+constexpr size_t NO_RAM = SIZE_MAX;
+
+struct Cartridge {
+    // Until a ROM is loaded: 32 KB of zeros and 8 KB of RAM, like the flat
+    // memory this emulator started out with
+    std::shared_ptr<const RomImage> rom = RomImage::blank();
+    std::vector<std::unique_ptr<uint8_t[]>> patched_banks;     // private copies, by bank number
+    std::vector<uint8_t> ram_heap = std::vector<uint8_t>(RAM_BANK_SIZE);
+    std::unique_ptr<SaveFile> save;     // battery-backed RAM, when the .sav could be mapped
+    uint8_t* ram = ram_heap.data();     // ram_heap or the save file's mapping
+    size_t ram_size = RAM_BANK_SIZE;
+    bool battery = false;
+    std::chrono::milliseconds save_sync_interval{ 1000 };   // set before loading
+    Mbc mbc = Mbc::NONE;
+    uint8_t type = 0x00;            // header byte 0x0147
+
+    // Bank registers as last written
+    bool ram_enabled = true;
+    uint16_t rom_bank = 1;          // MBC1: low 5 bits, MBC3: 7 bits, MBC5: 9 bits
+    uint8_t bank_hi = 0;            // MBC1: upper ROM / RAM bank bits; MBC3/MBC5: RAM bank (MBC3 08-0C: RTC)
+    bool mbc1_mode = false;         // MBC1 mode 1: bank_hi also applies to 0000-3FFF and RAM
+
+    uint64_t bank_switches = 0;     // register writes that changed a mapped bank
+
+    static const char* mbc_name(Mbc mbc) {
+        switch (mbc) {
+        case Mbc::MBC1: return "MBC1";
+        case Mbc::MBC3: return "MBC3";
+        case Mbc::MBC5: return "MBC5";
+        default: return "ROM only";
+        }
+    }
+
+    // Takes a ROM image and sets up the controller from its header. RAM of a
+    // battery-backed cart is kept in `save_path` unless that is empty.
+    void load(std::shared_ptr<const RomImage> image, const std::string& save_path) {
+        const uint8_t* header = image->data();
+        type = header[0x0147];
+        switch (type) {
+        case 0x00: case 0x08: case 0x09: mbc = Mbc::NONE; break;
+        case 0x01: case 0x02: case 0x03: mbc = Mbc::MBC1; break;
+        case 0x0F: case 0x10: case 0x11: case 0x12: case 0x13: mbc = Mbc::MBC3; break;
+        case 0x19: case 0x1A: case 0x1B: case 0x1C: case 0x1D: case 0x1E: mbc = Mbc::MBC5; break;
+        default:
+            printf("Unsupported cartridge type 0x%02X, running it as ROM only\n", type);
+            mbc = Mbc::NONE;
+            break;
+        }
+        switch (type) {
+        case 0x03: case 0x09: case 0x0F: case 0x10: case 0x13: case 0x1B: case 0x1E: battery = true; break;
+        default: battery = false; break;
+        }
+
+        rom = std::move(image);
+        patched_banks.clear();
+        patched_banks.resize(rom_banks());
+
+        static const size_t ram_sizes[] = { 0, 0x800, 0x2000, 0x8000, 0x20000, 0x10000 };
+        uint8_t ram_code = header[0x0149];
+        ram_size = ram_code < 6 ? ram_sizes[ram_code] : 0;
+        // ROM-only carts keep the always-on 8 KB this emulator has always had there
+        if (mbc == Mbc::NONE && ram_size < RAM_BANK_SIZE) ram_size = RAM_BANK_SIZE;
+        save.reset();
+        if (battery && ram_size && !save_path.empty())
+            save = SaveFile::open(save_path, ram_size, save_sync_interval);
+        if (save) {
+            ram_heap.clear();
+            ram = save->data();
+        }
+        else {
+            ram_heap.assign(ram_size, 0x00);
+            ram = ram_heap.data();
+        }
+
+        ram_enabled = mbc == Mbc::NONE;
+        rom_bank = 1;
+        bank_hi = 0;
+        mbc1_mode = false;
+    }
+
+    // Images are whole banks, a power of two of them
+    size_t rom_banks() const { return rom->size() / ROM_BANK_SIZE; }
+
+    // Host address of a ROM bank: the private copy if it was patched, else
+    // the shared image
+    const uint8_t* rom_bank_data(size_t bank) const {
+        if (is_patched(bank)) return patched_banks[bank].get();
+        return rom->data() + bank * ROM_BANK_SIZE;
+    }
+
+    bool is_patched(size_t bank) const { return bank < patched_banks.size() && patched_banks[bank]; }
+
+    // Makes a private, writable copy of a ROM bank (once) and returns it
+    uint8_t* patch_bank(size_t bank) {
+        if (patched_banks.size() < rom_banks()) patched_banks.resize(rom_banks());
+        if (!patched_banks[bank]) {
+            const uint8_t* shared = rom->data() + bank * ROM_BANK_SIZE;
+            patched_banks[bank].reset(new uint8_t[ROM_BANK_SIZE]);
+            std::copy(shared, shared + ROM_BANK_SIZE, patched_banks[bank].get());
+        }
+        return patched_banks[bank].get();
+    }
+
+    // Bank mapped at 0000-3FFF
+    size_t rom0_bank() const {
+        if (mbc == Mbc::MBC1 && mbc1_mode) return ((size_t)bank_hi << 5) & (rom_banks() - 1);
+        return 0;
+    }
+
+    // Bank mapped at 4000-7FFF
+    size_t rom1_bank() const {
+        size_t bank = rom_bank;
+        if (mbc == Mbc::MBC1) bank |= (size_t)bank_hi << 5;
+        return bank & (rom_banks() - 1);
+    }
+
+    // Offset of the RAM bank mapped at A000-BFFF, or NO_RAM when that range
+    // is not backed by RAM (disabled, absent, or an RTC register selected)
+    size_t ram_offset() const {
+        if (ram_size == 0 || !ram_enabled) return NO_RAM;
+        size_t bank = 0;
+        if (mbc == Mbc::MBC1) bank = mbc1_mode ? bank_hi : 0;
+        else if (mbc == Mbc::MBC3) {
+            if (bank_hi > 0x03) return NO_RAM;
+            bank = bank_hi;
+        }
+        else if (mbc == Mbc::MBC5) bank = bank_hi;
+        return bank * RAM_BANK_SIZE % ram_size;
+    }
+
+    // A write to 0000-7FFF. Returns true when the mapping may have changed.
+    bool write_register(uint16_t addr, uint8_t value) {
+        if (mbc == Mbc::NONE) return false;
+
+        size_t rom0 = rom0_bank(), rom1 = rom1_bank(), ram_at = ram_offset();
+        switch (addr >> 13) {
+        case 0:     // 0000-1FFF: RAM enable
+            ram_enabled = (value & 0x0F) == 0x0A;
+            break;
+        case 1:     // 2000-3FFF: ROM bank
+            if (mbc == Mbc::MBC1) {
+                rom_bank = value & 0x1F;
+                if (rom_bank == 0) rom_bank = 1;
+            }
+            else if (mbc == Mbc::MBC3) {
+                rom_bank = value & 0x7F;
+                if (rom_bank == 0) rom_bank = 1;
+            }
+            else if (addr < 0x3000) {
+                rom_bank = (rom_bank & 0x100) | value;
+            }
+            else {
+                rom_bank = (rom_bank & 0xFF) | ((value & 0x01) << 8);
+            }
+            break;
+        case 2:     // 4000-5FFF: RAM bank / upper ROM bits
+            bank_hi = mbc == Mbc::MBC1 ? value & 0x03 : mbc == Mbc::MBC5 ? value & 0x0F : value;
+            break;
+        case 3:     // 6000-7FFF: MBC1 banking mode (MBC3 clock latch is ignored)
+            if (mbc == Mbc::MBC1) mbc1_mode = value & 0x01;
+            break;
+        }
+
+        bool switched = rom0 != rom0_bank() || rom1 != rom1_bank();
+        if (ram_at != NO_RAM && ram_offset() != NO_RAM && ram_at != ram_offset()) switched = true;
+        if (switched) bank_switches++;
+        return switched || (ram_at == NO_RAM) != (ram_offset() == NO_RAM);
+    }
+};
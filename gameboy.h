@@ -0,0 +1,135 @@
+#pragma once
+#include <stdio.h>
+#include <cstdint>
+#include <memory>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "interpreter.h"
+#ifdef GB_BLOCK_CACHE
+#include "block_cache.h"
+#endif
+#ifdef GB_JIT
+#include "jit_x64.h"
+#endif
+
+// Execution core picked by the build flags
+#if defined(GB_JIT)
+typedef JitCore GameBoyCore;
+#elif defined(GB_BLOCK_CACHE)
+typedef BlockCore GameBoyCore;
+#else
+typedef Interpreter GameBoyCore;
+#endif
+
+// One complete emulated Game Boy: CPU, memory, PPU, framebuffer and whatever
+// caches the execution core keeps. Instances share nothing, so several can
+// run at once, each on its own thread. They are large (the block cache alone
+// is half a megabyte), so allocate them on the heap.
+struct GameBoy : GameBoyCore {
+    // Runs until at least `cycles` T-cycles have elapsed or `running` is
+    // cleared. Returns the number of cycles actually run.
+    int run(int cycles) {
+#if defined(GB_JIT)
+        int ran = cpu_run_jit(cycles);
+#elif defined(GB_BLOCK_CACHE)
+        int ran = cpu_run_blocks(cycles);
+#else
+        int ran = cpu_run(cycles);
+#endif
+        memory.publish_save_writes();
+        return ran;
+    }
+
+    // Maps the ROM file (shared with any other instance running the same
+    // game) and hands it to the cartridge, which sets up its bank controller
+    // from the header. Battery-backed RAM goes to the ROM's name with .sav.
+    bool load_rom(const std::string& filename) {
+        return load_rom(filename, default_save_path(filename));
+    }
+
+    // The same with battery-backed RAM kept in `save_path`, or only in
+    // memory when that is empty. Instances running the same game need
+    // their own save paths to each persist their RAM: a save file already
+    // open elsewhere is not shared (see save_file.h).
+    bool load_rom(const std::string& filename, const std::string& save_path) {
+        std::shared_ptr<const RomImage> image = RomCache::shared().open(filename);
+        if (!image) {
+            std::cerr << "Failed to load ROM: " << filename << "\n";
+            return false;
+        }
+        size_t size = image->size();
+        bool mapped = image->is_mapped();
+        memory.load_cartridge(std::move(image), save_path);
+
+        printf("Loaded ROM: %s (%zu bytes, %s)\n", filename.c_str(), size, mapped ? "mapped" : "copied");
+        printf("MBC type: 0x%02X\n", memory.read(0x0147));
+        printf("Cartridge: %s, %zu KB ROM, %zu KB RAM\n", Cartridge::mbc_name(memory.cart.mbc),
+            memory.cart.rom->size() / 1024, memory.cart.ram_size / 1024);
+        if (memory.cart.save)
+            printf("Save RAM: %s (synced every %lld ms)\n", memory.cart.save->path().c_str(),
+                (long long)memory.cart.save_sync_interval.count());
+
+        return true;
+    }
+
+    // The ROM's path with its extension replaced by .sav
+    static std::string default_save_path(const std::string& filename) {
+        std::string save_path = filename;
+        size_t dot = save_path.find_last_of('.');
+        if (dot != std::string::npos && save_path.find_first_of("/\\", dot) == std::string::npos) save_path.erase(dot);
+        return save_path + ".sav";
+    }
+
+    // Register and I/O state the boot ROM leaves behind
+    void init_fake_bios_state() {
+        // CPU Registers
+        cpu.A = 0x01; cpu.setF(0xB0);
+        printf("A & F are set as 0x%02X, 0x%02X\n", cpu.A, cpu.F);
+        cpu.setBC(0x0013);
+        cpu.setDE(0x00D8);
+        cpu.setHL(0x014D);
+        cpu.STACK_P = 0xFFFE;
+        cpu.PC = 0x0100;     // start of the cartridge's code
+
+        // Timers
+        memory.write(0xFF05, 0x00);
+        memory.write(0xFF06, 0x00);
+        memory.write(0xFF07, 0x00);
+
+        // Sound
+        memory.write(0xFF10, 0x80);
+        memory.write(0xFF11, 0xBF);
+        memory.write(0xFF12, 0xF3);
+        memory.write(0xFF14, 0xBF);
+        memory.write(0xFF16, 0x3F);
+        memory.write(0xFF17, 0x00);
+        memory.write(0xFF19, 0xBF);
+        memory.write(0xFF1A, 0x7F);
+        memory.write(0xFF1B, 0xFF);
+        memory.write(0xFF1C, 0x9F);
+        memory.write(0xFF1E, 0xBF);
+        memory.write(0xFF20, 0xFF);
+        memory.write(0xFF21, 0x00);
+        memory.write(0xFF22, 0x00);
+        memory.write(0xFF23, 0xBF);
+        memory.write(0xFF24, 0x77);
+        memory.write(0xFF25, 0xF3);
+        memory.write(0xFF26, 0xF1);
+
+        // PPU
+        memory.write(0xFF40, 0x91); // LCDC
+        memory.write(0xFF42, 0x00); // SCY
+        memory.write(0xFF43, 0x20); // SCX // offset after tunning
+        memory.write(0xFF45, 0x00); // LYC
+        memory.write(0xFF47, 0xFC); // BGP
+        memory.write(0xFF48, 0xFF); // OBP0
+        memory.write(0xFF49, 0xFF); // OBP1
+        memory.write(0xFF4A, 0x00); // WY
+        memory.write(0xFF4B, 0x00); // WX
+
+        // Interrupts
+        memory.write(0xFFFF, 0x00); // IE
+        memory.write(0xFF0F, 0x00); // IF
+    }
+};
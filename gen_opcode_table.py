@@ -0,0 +1,167 @@
+#!/usr/bin/env python3
+# Generates opcode_table.h from opcodes.json.
+#
+# The emulator used to parse opcodes.json at startup and look every executed
+# opcode up by string key. This script bakes both the "unprefixed" and
+# "cbprefixed" sets into constexpr arrays of small POD records instead, so the
+# hot loop only does an array index per instruction.
+#
+# Usage: python3 gen_opcode_table.py [--check] [opcodes.json] [opcode_table.h]
+#
+# The header is written with CRLF line endings, like the rest of the sources.
+# --check writes nothing and fails unless the committed header is byte for
+# byte what would be generated.
+
+import json
+import sys
+
+FLAG_BITS = [0x80, 0x40, 0x20, 0x10]  # Z N H C
+
+# Operand spellings in opcodes.json -> enum identifiers.
+OPERAND_IDS = {
+    "A": "A", "B": "B", "C": "C", "D": "D", "E": "E", "H": "H", "L": "L",
+    "AF": "AF", "BC": "BC", "DE": "DE", "HL": "HL", "SP": "SP",
+    "NZ": "NZ", "Z": "Z", "NC": "NC",
+    "(BC)": "BC_IND", "(DE)": "DE_IND", "(HL)": "HL_IND",
+    "(HL+)": "HLI_IND", "(HL-)": "HLD_IND", "(C)": "C_IND",
+    "(a8)": "A8_IND", "(a16)": "A16_IND",
+    "d8": "D8", "d16": "D16", "a16": "A16", "r8": "R8", "SP+r8": "SP_R8",
+    "00H": "RST_00", "08H": "RST_08", "10H": "RST_10", "18H": "RST_18",
+    "20H": "RST_20", "28H": "RST_28", "30H": "RST_30", "38H": "RST_38",
+    "0": "N0", "1": "N1", "2": "N2", "3": "N3",
+    "4": "N4", "5": "N5", "6": "N6", "7": "N7",
+    "CB": "CB",
+}
+
+
+def flag_masks(flags):
+    """Returns (set, clear, affected) bit masks for a Z/N/H/C flag list."""
+    set_mask = clear_mask = affected = 0
+    if len(flags) != 4:
+        return 0, 0, 0
+    for bit, flag in zip(FLAG_BITS, flags):
+        if flag == "1":
+            set_mask |= bit
+        elif flag == "0":
+            clear_mask |= bit
+        elif flag in ("Z", "N", "H", "C"):
+            affected |= bit
+    return set_mask, clear_mask, affected
+
+
+def main():
+    args = sys.argv[1:]
+    check = "--check" in args
+    if check:
+        args.remove("--check")
+    src = args[0] if len(args) > 0 else "opcodes.json"
+    dst = args[1] if len(args) > 1 else "opcode_table.h"
+
+    with open(src) as f:
+        data = json.load(f)
+
+    mnemonics = sorted({info["mnemonic"] for table in data.values() for info in table.values()})
+
+    for table in data.values():
+        for info in table.values():
+            for key in ("operand1", "operand2"):
+                if key in info and info[key] not in OPERAND_IDS:
+                    sys.exit("unknown operand '%s' in %s" % (info[key], info["addr"]))
+
+    operands = list(dict.fromkeys(OPERAND_IDS.values()))
+
+    def record(info):
+        if info is None:
+            return "{ Op::INVALID, Opd::NONE, Opd::NONE, 1, { 4, 0 }, 0x00, 0x00, 0x00 }"
+        cycles = info["cycles"] if isinstance(info["cycles"], list) else [info["cycles"]]
+        cycles = (cycles + [0])[:2]
+        length = info["length"]
+        s, c, a = flag_masks(info.get("flags", []))
+        return "{ Op::%s, Opd::%s, Opd::%s, %d, { %d, %d }, 0x%02X, 0x%02X, 0x%02X }" % (
+            info["mnemonic"],
+            OPERAND_IDS[info["operand1"]] if "operand1" in info else "NONE",
+            OPERAND_IDS[info["operand2"]] if "operand2" in info else "NONE",
+            length, cycles[0], cycles[1], s, c, a)
+
+    def table(name, entries):
+        lines = ["constexpr OpcodeInfo %s[256] = {" % name]
+        for i in range(256):
+            info = entries.get("0x%02x" % i)
+            comment = info["mnemonic"] if info else "--"
+            if info and "operand1" in info:
+                comment += " " + info["operand1"]
+                if "operand2" in info:
+                    comment += "," + info["operand2"]
+            lines.append("    %s, // 0x%02X %s" % (record(info), i, comment))
+        lines.append("};")
+        return "\n".join(lines)
+
+    out = []
+    out.append("// Generated by gen_opcode_table.py from opcodes.json - do not edit by hand.")
+    out.append("#pragma once")
+    out.append("#include <cstdint>")
+    out.append("")
+    out.append("enum class Op : uint8_t {")
+    out.append("    INVALID,")
+    for m in mnemonics:
+        out.append("    %s," % m)
+    out.append("};")
+    out.append("")
+    out.append("enum class Opd : uint8_t {")
+    out.append("    NONE,")
+    for o in operands:
+        out.append("    %s," % o)
+    out.append("};")
+    out.append("")
+    out.append("// One decoded opcode. cycles[1] is the not-taken cost of conditional")
+    out.append("// instructions and 0 otherwise. flags_set/flags_clear are the F bits the")
+    out.append("// instruction forces to 1/0, flags_affected the bits it computes.")
+    out.append("struct OpcodeInfo {")
+    out.append("    Op op;")
+    out.append("    Opd operand1;")
+    out.append("    Opd operand2;")
+    out.append("    uint8_t length;")
+    out.append("    uint8_t cycles[2];")
+    out.append("    uint8_t flags_set;")
+    out.append("    uint8_t flags_clear;")
+    out.append("    uint8_t flags_affected;")
+    out.append("};")
+    out.append("")
+    out.append("constexpr const char* op_names[] = {")
+    out.append('    "???",')
+    for m in mnemonics:
+        out.append('    "%s",' % m)
+    out.append("};")
+    out.append("")
+    spelling = {v: k for k, v in OPERAND_IDS.items()}
+    out.append("constexpr const char* operand_names[] = {")
+    out.append('    "",')
+    for o in operands:
+        out.append('    "%s",' % spelling[o])
+    out.append("};")
+    out.append("")
+    out.append("constexpr const char* op_name(Op op) { return op_names[static_cast<int>(op)]; }")
+    out.append("constexpr const char* operand_name(Opd opd) { return operand_names[static_cast<int>(opd)]; }")
+    out.append("")
+    out.append(table("unprefixed_table", data["unprefixed"]))
+    out.append("")
+    out.append(table("cbprefixed_table", data["cbprefixed"]))
+    out.append("")
+
+    header = "\n".join(out).replace("\n", "\r\n").encode()
+    if check:
+        try:
+            with open(dst, "rb") as f:
+                current = f.read()
+        except FileNotFoundError:
+            current = None
+        if current != header:
+            print("%s is out of date with %s; run python3 gen_opcode_table.py" % (dst, src))
+            sys.exit(1)
+        return
+    with open(dst, "wb") as f:
+        f.write(header)
+
+
+if __name__ == "__main__":
+    main()
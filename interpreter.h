@@ -0,0 +1,920 @@
+#pragma once
+#include <stdio.h>
+#include <cstdint>
+#include <cstdlib>
+#include <array>
+#include <utility>
+#include "machine.h"
+#include "opcode_table.h"
+
+// SM83 interpreter: one handler per opcode, reached through a 256-entry table
+// (plus a 256-entry table for CB-prefixed opcodes). Handlers fetch their own
+// operands, so PC always points at the next instruction once they return, and
+// they add their T-cycle cost to cpu.clock_cycles.
+//
+// On GCC/Clang cpu_run() uses computed goto instead of the function table, so
+// every opcode ends with its own indirect jump to the next one. Build with
+// GB_NO_COMPUTED_GOTO to force the table loop (e.g. to compare the two).
+
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(GB_NO_COMPUTED_GOTO)
+#define GB_COMPUTED_GOTO 1
+#endif
+
+// The JIT compiles blocks found by the block cache
+#if defined(GB_JIT) && !defined(GB_BLOCK_CACHE)
+#define GB_BLOCK_CACHE
+#endif
+
+// Opcode fields, decoded at compile time by the templated handlers below.
+constexpr int r8_dst(uint8_t opcode) { return (opcode >> 3) & 7; }
+constexpr int r8_src(uint8_t opcode) { return opcode & 7; }
+constexpr int r16_field(uint8_t opcode) { return (opcode >> 4) & 3; }
+constexpr int cc_field(uint8_t opcode) { return (opcode >> 3) & 3; }
+
+// Extra T-cycles when an 8-bit operand is (HL)
+template <int R> constexpr int hl_penalty(int cycles) { return R == 6 ? cycles : 0; }
+
+static inline uint8_t make_flags(bool z, bool n, bool h, bool c) {
+    return (z ? 0x80 : 0) | (n ? 0x40 : 0) | (h ? 0x20 : 0) | (c ? 0x10 : 0);
+}
+
+// The interpreter is a layer over Machine: handlers are member functions, so
+// each one works on its own machine's cpu/memory/ppu and any number of
+// machines can run side by side.
+struct Interpreter : Machine {
+    typedef void (Interpreter::*OpHandler)(uint8_t opcode);
+
+    // ===================== OPERAND ACCESS =====================
+
+    uint8_t fetch8() {
+        return memory.read(cpu.PC++);
+    }
+
+    uint16_t fetch16() {
+        uint8_t lo = memory.read(cpu.PC++);
+        uint8_t hi = memory.read(cpu.PC++);
+        return (hi << 8) | lo;
+    }
+
+    void push16(uint16_t value) {
+        cpu.STACK_P -= 2;
+        memory.write(cpu.STACK_P + 1, value >> 8);
+        memory.write(cpu.STACK_P, value & 0xFF);
+    }
+
+    uint16_t pop16() {
+        uint8_t lo = memory.read_data(cpu.STACK_P);
+        uint8_t hi = memory.read_data(cpu.STACK_P + 1);
+        cpu.STACK_P += 2;
+        return (hi << 8) | lo;
+    }
+
+    // 8-bit register operand as encoded in opcode bits: B C D E H L (HL) A
+    template <int R> uint8_t get_r8() {
+        if constexpr (R == 0) return cpu.B;
+        else if constexpr (R == 1) return cpu.C;
+        else if constexpr (R == 2) return cpu.D;
+        else if constexpr (R == 3) return cpu.E;
+        else if constexpr (R == 4) return cpu.H;
+        else if constexpr (R == 5) return cpu.L;
+        else if constexpr (R == 6) return memory.read_data(cpu.getHL());
+        else return cpu.A;
+    }
+
+    template <int R> void set_r8(uint8_t value) {
+        if constexpr (R == 0) cpu.B = value;
+        else if constexpr (R == 1) cpu.C = value;
+        else if constexpr (R == 2) cpu.D = value;
+        else if constexpr (R == 3) cpu.E = value;
+        else if constexpr (R == 4) cpu.H = value;
+        else if constexpr (R == 5) cpu.L = value;
+        else if constexpr (R == 6) memory.write(cpu.getHL(), value);
+        else cpu.A = value;
+    }
+
+    // 16-bit register operand: BC DE HL SP
+    template <int RR> uint16_t get_r16() {
+        if constexpr (RR == 0) return cpu.getBC();
+        else if constexpr (RR == 1) return cpu.getDE();
+        else if constexpr (RR == 2) return cpu.getHL();
+        else return cpu.STACK_P;
+    }
+
+    template <int RR> void set_r16(uint16_t value) {
+        if constexpr (RR == 0) cpu.setBC(value);
+        else if constexpr (RR == 1) cpu.setDE(value);
+        else if constexpr (RR == 2) cpu.setHL(value);
+        else cpu.STACK_P = value;
+    }
+
+    // Branch condition: NZ Z NC C
+    template <int CC> bool condition() {
+        if constexpr (CC == 0) return !cpu.getFlagZ();
+        else if constexpr (CC == 1) return cpu.getFlagZ();
+        else if constexpr (CC == 2) return !cpu.getFlagC();
+        else return cpu.getFlagC();
+    }
+
+    // ======================== ALU ============================
+
+    void alu_add(uint8_t value, int carry) {
+        int result = cpu.A + value + carry;
+        cpu.flagsAdd(cpu.A, value, carry, result);
+        cpu.A = result & 0xFF;
+    }
+
+    uint8_t alu_sub(uint8_t value, int carry) {
+        int result = cpu.A - value - carry;
+        cpu.flagsSub(cpu.A, value, carry, result);
+        return result & 0xFF;
+    }
+
+    void alu_and(uint8_t value) {
+        cpu.A &= value;
+        cpu.flagsZero(cpu.A, 0x20);
+    }
+
+    void alu_xor(uint8_t value) {
+        cpu.A ^= value;
+        cpu.flagsZero(cpu.A, 0x00);
+    }
+
+    void alu_or(uint8_t value) {
+        cpu.A |= value;
+        cpu.flagsZero(cpu.A, 0x00);
+    }
+
+    uint8_t alu_inc(uint8_t value) {
+        uint8_t result = value + 1;
+        cpu.flagsInc(result);
+        return result;
+    }
+
+    uint8_t alu_dec(uint8_t value) {
+        uint8_t result = value - 1;
+        cpu.flagsDec(result);
+        return result;
+    }
+
+    void alu_add_hl(uint16_t value) {
+        uint16_t hl = cpu.getHL();
+        uint32_t result = hl + value;
+        cpu.setF(make_flags(cpu.getFlagZ(), false, ((hl & 0x0FFF) + (value & 0x0FFF)) > 0x0FFF, result > 0xFFFF));
+        cpu.setHL(result & 0xFFFF);
+    }
+
+    // SP + signed immediate, shared by ADD SP,r8 and LD HL,SP+r8
+    uint16_t alu_sp_offset(uint8_t imm) {
+        uint16_t sp = cpu.STACK_P;
+        cpu.setF(make_flags(false, false, ((sp & 0x0F) + (imm & 0x0F)) > 0x0F, ((sp & 0xFF) + imm) > 0xFF));
+        return sp + (int8_t)imm;
+    }
+
+    // CB-prefixed shift/rotate group, selected by bits 3-5 of the CB opcode:
+    // RLC RRC RL RR SLA SRA SWAP SRL
+    template <int KIND> uint8_t alu_shift(uint8_t value) {
+        uint8_t result;
+        bool carry;
+        if constexpr (KIND == 0) { result = (value << 1) | (value >> 7); carry = value & 0x80; }
+        else if constexpr (KIND == 1) { result = (value >> 1) | (value << 7); carry = value & 0x01; }
+        else if constexpr (KIND == 2) { result = (value << 1) | cpu.getFlagC(); carry = value & 0x80; }
+        else if constexpr (KIND == 3) { result = (value >> 1) | (cpu.getFlagC() << 7); carry = value & 0x01; }
+        else if constexpr (KIND == 4) { result = value << 1; carry = value & 0x80; }
+        else if constexpr (KIND == 5) { result = (value >> 1) | (value & 0x80); carry = value & 0x01; }
+        else if constexpr (KIND == 6) { result = (value << 4) | (value >> 4); carry = false; }
+        else { result = value >> 1; carry = value & 0x01; }
+        cpu.flagsZero(result, carry ? 0x10 : 0x00);
+        return result;
+    }
+
+    // ===================== HANDLERS ==========================
+
+    // Handlers for register-operand families (LD r,r', ALU A,r, INC/DEC, the
+    // 16-bit pair ops, conditional branches and every CB opcode) are templates
+    // on their opcode. The register, pair and condition fields are decoded from
+    // it at compile time, so each instantiation is straight-line code with no
+    // register lookup.
+
+    // ---------------- misc / control ----------------
+    void op_nop(uint8_t) {
+        cpu.clock_cycles += 4;
+    }
+
+    void op_illegal(uint8_t opcode) {
+        printf("Unknown opcode: 0x%02X at 0x%04X\n", opcode, cpu.PC - 1);
+        cpu.clock_cycles += 4;
+    }
+
+    void op_stop(uint8_t) {
+        fetch8();
+        cpu.clock_cycles += 4;
+    }
+
+    void op_halt(uint8_t) {
+        uint8_t pending = memory.read(0xFFFF) & memory.read(0xFF0F) & 0x1F;
+        if (!cpu.IME && pending) {
+            // HALT bug: the next opcode byte is read twice
+            cpu.halt_bug = true;
+        }
+        else {
+            cpu.halted = true;
+            scheduler.schedule_now(EVENT_INTERRUPT);
+        }
+        cpu.clock_cycles += 4;
+    }
+
+    void op_di(uint8_t) {
+        cpu.IME = false;
+        cpu.IME_Pending = false;
+        cpu.clock_cycles += 4;
+    }
+
+    void op_ei(uint8_t) {
+        // IME is set after the instruction that follows EI
+        cpu.IME_Pending = true;
+        cpu.clock_cycles += 4;
+    }
+
+    void op_daa(uint8_t) {
+        uint8_t a = cpu.A;
+        uint8_t f = cpu.getF();
+        bool c = f & 0x10;
+        if (!(f & 0x40)) {
+            if (c || a > 0x99) { a += 0x60; c = true; }
+            if ((f & 0x20) || (a & 0x0F) > 0x09) a += 0x06;
+        }
+        else {
+            if (c) a -= 0x60;
+            if (f & 0x20) a -= 0x06;
+        }
+        cpu.A = a;
+        cpu.setF((f & 0x40) | make_flags(a == 0, false, false, c));
+        cpu.clock_cycles += 4;
+    }
+
+    void op_cpl(uint8_t) {
+        cpu.A = ~cpu.A;
+        cpu.setF(cpu.getF() | 0x60);
+        cpu.clock_cycles += 4;
+    }
+
+    void op_scf(uint8_t) {
+        cpu.setF(make_flags(cpu.getFlagZ(), false, false, true));
+        cpu.clock_cycles += 4;
+    }
+
+    void op_ccf(uint8_t) {
+        cpu.setF(make_flags(cpu.getFlagZ(), false, false, !cpu.getFlagC()));
+        cpu.clock_cycles += 4;
+    }
+
+    // ---------------- 8-bit loads ----------------
+    template <uint8_t OP> void op_ld_r_r(uint8_t) {
+        constexpr int dst = r8_dst(OP);
+        constexpr int src = r8_src(OP);
+        set_r8<dst>(get_r8<src>());
+        cpu.clock_cycles += 4 + hl_penalty<dst>(4) + hl_penalty<src>(4);
+    }
+
+    template <uint8_t OP> void op_ld_r_d8(uint8_t) {
+        constexpr int dst = r8_dst(OP);
+        set_r8<dst>(fetch8());
+        cpu.clock_cycles += 8 + hl_penalty<dst>(4);
+    }
+
+    void op_ld_bc_a(uint8_t) {
+        memory.write(cpu.getBC(), cpu.A);
+        cpu.clock_cycles += 8;
+    }
+
+    void op_ld_de_a(uint8_t) {
+        memory.write(cpu.getDE(), cpu.A);
+        cpu.clock_cycles += 8;
+    }
+
+    void op_ld_hli_a(uint8_t) {
+        uint16_t hl = cpu.getHL();
+        memory.write(hl, cpu.A);
+        cpu.setHL(hl + 1);
+        cpu.clock_cycles += 8;
+    }
+
+    void op_ld_hld_a(uint8_t) {
+        uint16_t hl = cpu.getHL();
+        memory.write(hl, cpu.A);
+        cpu.setHL(hl - 1);
+        cpu.clock_cycles += 8;
+    }
+
+    void op_ld_a_bc(uint8_t) {
+        cpu.A = memory.read_data(cpu.getBC());
+        cpu.clock_cycles += 8;
+    }
+
+    void op_ld_a_de(uint8_t) {
+        cpu.A = memory.read_data(cpu.getDE());
+        cpu.clock_cycles += 8;
+    }
+
+    void op_ld_a_hli(uint8_t) {
+        uint16_t hl = cpu.getHL();
+        cpu.A = memory.read_data(hl);
+        cpu.setHL(hl + 1);
+        cpu.clock_cycles += 8;
+    }
+
+    void op_ld_a_hld(uint8_t) {
+        uint16_t hl = cpu.getHL();
+        cpu.A = memory.read_data(hl);
+        cpu.setHL(hl - 1);
+        cpu.clock_cycles += 8;
+    }
+
+    void op_ldh_a8_a(uint8_t) {
+        memory.write(0xFF00 + fetch8(), cpu.A);
+        cpu.clock_cycles += 12;
+    }
+
+    void op_ldh_a_a8(uint8_t) {
+        cpu.A = memory.read_data(0xFF00 + fetch8());
+        cpu.clock_cycles += 12;
+    }
+
+    void op_ld_c_ind_a(uint8_t) {
+        memory.write(0xFF00 + cpu.C, cpu.A);
+        cpu.clock_cycles += 8;
+    }
+
+    void op_ld_a_c_ind(uint8_t) {
+        cpu.A = memory.read_data(0xFF00 + cpu.C);
+        cpu.clock_cycles += 8;
+    }
+
+    void op_ld_a16_a(uint8_t) {
+        memory.write(fetch16(), cpu.A);
+        cpu.clock_cycles += 16;
+    }
+
+    void op_ld_a_a16(uint8_t) {
+        cpu.A = memory.read_data(fetch16());
+        cpu.clock_cycles += 16;
+    }
+
+    // ---------------- 16-bit loads ----------------
+    template <uint8_t OP> void op_ld_rr_d16(uint8_t) {
+        set_r16<r16_field(OP)>(fetch16());
+        cpu.clock_cycles += 12;
+    }
+
+    void op_ld_a16_sp(uint8_t) {
+        uint16_t addr = fetch16();
+        memory.write(addr, cpu.STACK_P & 0xFF);
+        memory.write(addr + 1, cpu.STACK_P >> 8);
+        cpu.clock_cycles += 20;
+    }
+
+    void op_ld_sp_hl(uint8_t) {
+        cpu.STACK_P = cpu.getHL();
+        cpu.clock_cycles += 8;
+    }
+
+    void op_ld_hl_sp_r8(uint8_t) {
+        cpu.setHL(alu_sp_offset(fetch8()));
+        cpu.clock_cycles += 12;
+    }
+
+    template <uint8_t OP> void op_push(uint8_t) {
+        constexpr int rr = r16_field(OP);
+        if constexpr (rr == 3) push16(cpu.getAF());
+        else push16(get_r16<rr>());
+        cpu.clock_cycles += 16;
+    }
+
+    template <uint8_t OP> void op_pop(uint8_t) {
+        constexpr int rr = r16_field(OP);
+        if constexpr (rr == 3) cpu.setAF(pop16());
+        else set_r16<rr>(pop16());
+        cpu.clock_cycles += 12;
+    }
+
+    // ---------------- 8-bit ALU ----------------
+    template <uint8_t OP> void op_inc_r(uint8_t) {
+        constexpr int r = r8_dst(OP);
+        set_r8<r>(alu_inc(get_r8<r>()));
+        cpu.clock_cycles += 4 + hl_penalty<r>(8);
+    }
+
+    template <uint8_t OP> void op_dec_r(uint8_t) {
+        constexpr int r = r8_dst(OP);
+        set_r8<r>(alu_dec(get_r8<r>()));
+        cpu.clock_cycles += 4 + hl_penalty<r>(8);
+    }
+
+    template <uint8_t OP> void op_add_r(uint8_t) {
+        alu_add(get_r8<r8_src(OP)>(), 0);
+        cpu.clock_cycles += 4 + hl_penalty<r8_src(OP)>(4);
+    }
+
+    template <uint8_t OP> void op_adc_r(uint8_t) {
+        alu_add(get_r8<r8_src(OP)>(), cpu.getFlagC());
+        cpu.clock_cycles += 4 + hl_penalty<r8_src(OP)>(4);
+    }
+
+    template <uint8_t OP> void op_sub_r(uint8_t) {
+        cpu.A = alu_sub(get_r8<r8_src(OP)>(), 0);
+        cpu.clock_cycles += 4 + hl_penalty<r8_src(OP)>(4);
+    }
+
+    template <uint8_t OP> void op_sbc_r(uint8_t) {
+        cpu.A = alu_sub(get_r8<r8_src(OP)>(), cpu.getFlagC());
+        cpu.clock_cycles += 4 + hl_penalty<r8_src(OP)>(4);
+    }
+
+    template <uint8_t OP> void op_and_r(uint8_t) {
+        alu_and(get_r8<r8_src(OP)>());
+        cpu.clock_cycles += 4 + hl_penalty<r8_src(OP)>(4);
+    }
+
+    template <uint8_t OP> void op_xor_r(uint8_t) {
+        alu_xor(get_r8<r8_src(OP)>());
+        cpu.clock_cycles += 4 + hl_penalty<r8_src(OP)>(4);
+    }
+
+    template <uint8_t OP> void op_or_r(uint8_t) {
+        alu_or(get_r8<r8_src(OP)>());
+        cpu.clock_cycles += 4 + hl_penalty<r8_src(OP)>(4);
+    }
+
+    template <uint8_t OP> void op_cp_r(uint8_t) {
+        alu_sub(get_r8<r8_src(OP)>(), 0);
+        cpu.clock_cycles += 4 + hl_penalty<r8_src(OP)>(4);
+    }
+
+    void op_add_d8(uint8_t) { alu_add(fetch8(), 0); cpu.clock_cycles += 8; }
+    void op_adc_d8(uint8_t) { alu_add(fetch8(), cpu.getFlagC()); cpu.clock_cycles += 8; }
+    void op_sub_d8(uint8_t) { cpu.A = alu_sub(fetch8(), 0); cpu.clock_cycles += 8; }
+    void op_sbc_d8(uint8_t) { cpu.A = alu_sub(fetch8(), cpu.getFlagC()); cpu.clock_cycles += 8; }
+    void op_and_d8(uint8_t) { alu_and(fetch8()); cpu.clock_cycles += 8; }
+    void op_xor_d8(uint8_t) { alu_xor(fetch8()); cpu.clock_cycles += 8; }
+    void op_or_d8(uint8_t) { alu_or(fetch8()); cpu.clock_cycles += 8; }
+    void op_cp_d8(uint8_t) { alu_sub(fetch8(), 0); cpu.clock_cycles += 8; }
+
+    // Accumulator rotates always clear Z, unlike their CB counterparts
+    void op_rlca(uint8_t) {
+        cpu.A = alu_shift<0>(cpu.A);
+        cpu.setF(make_flags(false, false, false, cpu.getFlagC()));
+        cpu.clock_cycles += 4;
+    }
+
+    void op_rrca(uint8_t) {
+        cpu.A = alu_shift<1>(cpu.A);
+        cpu.setF(make_flags(false, false, false, cpu.getFlagC()));
+        cpu.clock_cycles += 4;
+    }
+
+    void op_rla(uint8_t) {
+        cpu.A = alu_shift<2>(cpu.A);
+        cpu.setF(make_flags(false, false, false, cpu.getFlagC()));
+        cpu.clock_cycles += 4;
+    }
+
+    void op_rra(uint8_t) {
+        cpu.A = alu_shift<3>(cpu.A);
+        cpu.setF(make_flags(false, false, false, cpu.getFlagC()));
+        cpu.clock_cycles += 4;
+    }
+
+    // ---------------- 16-bit ALU ----------------
+    template <uint8_t OP> void op_inc_rr(uint8_t) {
+        constexpr int rr = r16_field(OP);
+        set_r16<rr>(get_r16<rr>() + 1);
+        cpu.clock_cycles += 8;
+    }
+
+    template <uint8_t OP> void op_dec_rr(uint8_t) {
+        constexpr int rr = r16_field(OP);
+        set_r16<rr>(get_r16<rr>() - 1);
+        cpu.clock_cycles += 8;
+    }
+
+    template <uint8_t OP> void op_add_hl_rr(uint8_t) {
+        alu_add_hl(get_r16<r16_field(OP)>());
+        cpu.clock_cycles += 8;
+    }
+
+    void op_add_sp_r8(uint8_t) {
+        cpu.STACK_P = alu_sp_offset(fetch8());
+        cpu.clock_cycles += 16;
+    }
+
+    // ---------------- jumps / calls ----------------
+    void op_jr(uint8_t) {
+        int8_t offset = (int8_t)fetch8();
+        cpu.PC += offset;
+        cpu.clock_cycles += 12;
+    }
+
+    template <uint8_t OP> void op_jr_cc(uint8_t) {
+        int8_t offset = (int8_t)fetch8();
+        if (condition<cc_field(OP)>()) {
+            cpu.PC += offset;
+            cpu.clock_cycles += 12;
+        }
+        else {
+            cpu.clock_cycles += 8;
+        }
+    }
+
+    void op_jp(uint8_t) {
+        cpu.PC = fetch16();
+        cpu.clock_cycles += 16;
+    }
+
+    template <uint8_t OP> void op_jp_cc(uint8_t) {
+        uint16_t addr = fetch16();
+        if (condition<cc_field(OP)>()) {
+            cpu.PC = addr;
+            cpu.clock_cycles += 16;
+        }
+        else {
+            cpu.clock_cycles += 12;
+        }
+    }
+
+    void op_jp_hl(uint8_t) {
+        cpu.PC = cpu.getHL();
+        cpu.clock_cycles += 4;
+    }
+
+    void op_call(uint8_t) {
+        uint16_t addr = fetch16();
+        push16(cpu.PC);
+        cpu.PC = addr;
+        cpu.clock_cycles += 24;
+    }
+
+    template <uint8_t OP> void op_call_cc(uint8_t) {
+        uint16_t addr = fetch16();
+        if (condition<cc_field(OP)>()) {
+            push16(cpu.PC);
+            cpu.PC = addr;
+            cpu.clock_cycles += 24;
+        }
+        else {
+            cpu.clock_cycles += 12;
+        }
+    }
+
+    void op_ret(uint8_t) {
+        cpu.PC = pop16();
+        cpu.clock_cycles += 16;
+    }
+
+    template <uint8_t OP> void op_ret_cc(uint8_t) {
+        if (condition<cc_field(OP)>()) {
+            cpu.PC = pop16();
+            cpu.clock_cycles += 20;
+        }
+        else {
+            cpu.clock_cycles += 8;
+        }
+    }
+
+    void op_reti(uint8_t) {
+        cpu.PC = pop16();
+        cpu.IME = true;
+        scheduler.schedule_now(EVENT_INTERRUPT);
+        cpu.clock_cycles += 16;
+    }
+
+    template <uint8_t OP> void op_rst(uint8_t) {
+        push16(cpu.PC);
+        cpu.PC = OP & 0x38;
+        cpu.clock_cycles += 16;
+    }
+
+    // ---------------- CB prefix ----------------
+    template <uint8_t OP> void cb_op(uint8_t) {
+        constexpr int r = r8_src(OP);
+        constexpr int n = r8_dst(OP);
+        if constexpr (OP < 0x40) {
+            // RLC RRC RL RR SLA SRA SWAP SRL
+            set_r8<r>(alu_shift<n>(get_r8<r>()));
+            cpu.clock_cycles += 8 + hl_penalty<r>(8);
+        }
+        else if constexpr (OP < 0x80) {
+            cpu.flagsZero(get_r8<r>() & (1 << n), make_flags(false, false, true, cpu.getFlagC()));
+            cpu.clock_cycles += 8 + hl_penalty<r>(4);
+        }
+        else if constexpr (OP < 0xC0) {
+            set_r8<r>(get_r8<r>() & ~(1 << n));
+            cpu.clock_cycles += 8 + hl_penalty<r>(8);
+        }
+        else {
+            set_r8<r>(get_r8<r>() | (1 << n));
+            cpu.clock_cycles += 8 + hl_penalty<r>(8);
+        }
+    }
+
+    template <size_t... I>
+    static constexpr std::array<OpHandler, 256> make_cb_handlers(std::index_sequence<I...>) {
+        return { { &Interpreter::cb_op<static_cast<uint8_t>(I)>... } };
+    }
+
+    static const std::array<OpHandler, 256> cb_handlers;
+
+    void op_prefix_cb(uint8_t) {
+        uint8_t cb_opcode = fetch8();
+        (this->*cb_handlers[cb_opcode])(cb_opcode);
+    }
+
+    // ================== DISPATCH TABLE =======================
+
+    // All 256 unprefixed opcodes: X(opcode, handler) for plain handlers and
+    // T(opcode, handler) for handler templates instantiated on their opcode.
+    // Used for both the function table and the computed-goto labels so the two
+    // can't drift.
+#define GB_OPCODE_LIST(X, T) \
+        X(0x00, op_nop)         T(0x01, op_ld_rr_d16)   X(0x02, op_ld_bc_a)     T(0x03, op_inc_rr) \
+        T(0x04, op_inc_r)       T(0x05, op_dec_r)       T(0x06, op_ld_r_d8)     X(0x07, op_rlca) \
+        X(0x08, op_ld_a16_sp)   T(0x09, op_add_hl_rr)   X(0x0A, op_ld_a_bc)     T(0x0B, op_dec_rr) \
+        T(0x0C, op_inc_r)       T(0x0D, op_dec_r)       T(0x0E, op_ld_r_d8)     X(0x0F, op_rrca) \
+        X(0x10, op_stop)        T(0x11, op_ld_rr_d16)   X(0x12, op_ld_de_a)     T(0x13, op_inc_rr) \
+        T(0x14, op_inc_r)       T(0x15, op_dec_r)       T(0x16, op_ld_r_d8)     X(0x17, op_rla) \
+        X(0x18, op_jr)          T(0x19, op_add_hl_rr)   X(0x1A, op_ld_a_de)     T(0x1B, op_dec_rr) \
+        T(0x1C, op_inc_r)       T(0x1D, op_dec_r)       T(0x1E, op_ld_r_d8)     X(0x1F, op_rra) \
+        T(0x20, op_jr_cc)       T(0x21, op_ld_rr_d16)   X(0x22, op_ld_hli_a)    T(0x23, op_inc_rr) \
+        T(0x24, op_inc_r)       T(0x25, op_dec_r)       T(0x26, op_ld_r_d8)     X(0x27, op_daa) \
+        T(0x28, op_jr_cc)       T(0x29, op_add_hl_rr)   X(0x2A, op_ld_a_hli)    T(0x2B, op_dec_rr) \
+        T(0x2C, op_inc_r)       T(0x2D, op_dec_r)       T(0x2E, op_ld_r_d8)     X(0x2F, op_cpl) \
+        T(0x30, op_jr_cc)       T(0x31, op_ld_rr_d16)   X(0x32, op_ld_hld_a)    T(0x33, op_inc_rr) \
+        T(0x34, op_inc_r)       T(0x35, op_dec_r)       T(0x36, op_ld_r_d8)     X(0x37, op_scf) \
+        T(0x38, op_jr_cc)       T(0x39, op_add_hl_rr)   X(0x3A, op_ld_a_hld)    T(0x3B, op_dec_rr) \
+        T(0x3C, op_inc_r)       T(0x3D, op_dec_r)       T(0x3E, op_ld_r_d8)     X(0x3F, op_ccf) \
+        T(0x40, op_ld_r_r)      T(0x41, op_ld_r_r)      T(0x42, op_ld_r_r)      T(0x43, op_ld_r_r) \
+        T(0x44, op_ld_r_r)      T(0x45, op_ld_r_r)      T(0x46, op_ld_r_r)      T(0x47, op_ld_r_r) \
+        T(0x48, op_ld_r_r)      T(0x49, op_ld_r_r)      T(0x4A, op_ld_r_r)      T(0x4B, op_ld_r_r) \
+        T(0x4C, op_ld_r_r)      T(0x4D, op_ld_r_r)      T(0x4E, op_ld_r_r)      T(0x4F, op_ld_r_r) \
+        T(0x50, op_ld_r_r)      T(0x51, op_ld_r_r)      T(0x52, op_ld_r_r)      T(0x53, op_ld_r_r) \
+        T(0x54, op_ld_r_r)      T(0x55, op_ld_r_r)      T(0x56, op_ld_r_r)      T(0x57, op_ld_r_r) \
+        T(0x58, op_ld_r_r)      T(0x59, op_ld_r_r)      T(0x5A, op_ld_r_r)      T(0x5B, op_ld_r_r) \
+        T(0x5C, op_ld_r_r)      T(0x5D, op_ld_r_r)      T(0x5E, op_ld_r_r)      T(0x5F, op_ld_r_r) \
+        T(0x60, op_ld_r_r)      T(0x61, op_ld_r_r)      T(0x62, op_ld_r_r)      T(0x63, op_ld_r_r) \
+        T(0x64, op_ld_r_r)      T(0x65, op_ld_r_r)      T(0x66, op_ld_r_r)      T(0x67, op_ld_r_r) \
+        T(0x68, op_ld_r_r)      T(0x69, op_ld_r_r)      T(0x6A, op_ld_r_r)      T(0x6B, op_ld_r_r) \
+        T(0x6C, op_ld_r_r)      T(0x6D, op_ld_r_r)      T(0x6E, op_ld_r_r)      T(0x6F, op_ld_r_r) \
+        T(0x70, op_ld_r_r)      T(0x71, op_ld_r_r)      T(0x72, op_ld_r_r)      T(0x73, op_ld_r_r) \
+        T(0x74, op_ld_r_r)      T(0x75, op_ld_r_r)      X(0x76, op_halt)        T(0x77, op_ld_r_r) \
+        T(0x78, op_ld_r_r)      T(0x79, op_ld_r_r)      T(0x7A, op_ld_r_r)      T(0x7B, op_ld_r_r) \
+        T(0x7C, op_ld_r_r)      T(0x7D, op_ld_r_r)      T(0x7E, op_ld_r_r)      T(0x7F, op_ld_r_r) \
+        T(0x80, op_add_r)       T(0x81, op_add_r)       T(0x82, op_add_r)       T(0x83, op_add_r) \
+        T(0x84, op_add_r)       T(0x85, op_add_r)       T(0x86, op_add_r)       T(0x87, op_add_r) \
+        T(0x88, op_adc_r)       T(0x89, op_adc_r)       T(0x8A, op_adc_r)       T(0x8B, op_adc_r) \
+        T(0x8C, op_adc_r)       T(0x8D, op_adc_r)       T(0x8E, op_adc_r)       T(0x8F, op_adc_r) \
+        T(0x90, op_sub_r)       T(0x91, op_sub_r)       T(0x92, op_sub_r)       T(0x93, op_sub_r) \
+        T(0x94, op_sub_r)       T(0x95, op_sub_r)       T(0x96, op_sub_r)       T(0x97, op_sub_r) \
+        T(0x98, op_sbc_r)       T(0x99, op_sbc_r)       T(0x9A, op_sbc_r)       T(0x9B, op_sbc_r) \
+        T(0x9C, op_sbc_r)       T(0x9D, op_sbc_r)       T(0x9E, op_sbc_r)       T(0x9F, op_sbc_r) \
+        T(0xA0, op_and_r)       T(0xA1, op_and_r)       T(0xA2, op_and_r)       T(0xA3, op_and_r) \
+        T(0xA4, op_and_r)       T(0xA5, op_and_r)       T(0xA6, op_and_r)       T(0xA7, op_and_r) \
+        T(0xA8, op_xor_r)       T(0xA9, op_xor_r)       T(0xAA, op_xor_r)       T(0xAB, op_xor_r) \
+        T(0xAC, op_xor_r)       T(0xAD, op_xor_r)       T(0xAE, op_xor_r)       T(0xAF, op_xor_r) \
+        T(0xB0, op_or_r)        T(0xB1, op_or_r)        T(0xB2, op_or_r)        T(0xB3, op_or_r) \
+        T(0xB4, op_or_r)        T(0xB5, op_or_r)        T(0xB6, op_or_r)        T(0xB7, op_or_r) \
+        T(0xB8, op_cp_r)        T(0xB9, op_cp_r)        T(0xBA, op_cp_r)        T(0xBB, op_cp_r) \
+        T(0xBC, op_cp_r)        T(0xBD, op_cp_r)        T(0xBE, op_cp_r)        T(0xBF, op_cp_r) \
+        T(0xC0, op_ret_cc)      T(0xC1, op_pop)         T(0xC2, op_jp_cc)       X(0xC3, op_jp) \
+        T(0xC4, op_call_cc)     T(0xC5, op_push)        X(0xC6, op_add_d8)      T(0xC7, op_rst) \
+        T(0xC8, op_ret_cc)      X(0xC9, op_ret)         T(0xCA, op_jp_cc)       X(0xCB, op_prefix_cb) \
+        T(0xCC, op_call_cc)     X(0xCD, op_call)        X(0xCE, op_adc_d8)      T(0xCF, op_rst) \
+        T(0xD0, op_ret_cc)      T(0xD1, op_pop)         T(0xD2, op_jp_cc)       X(0xD3, op_illegal) \
+        T(0xD4, op_call_cc)     T(0xD5, op_push)        X(0xD6, op_sub_d8)      T(0xD7, op_rst) \
+        T(0xD8, op_ret_cc)      X(0xD9, op_reti)        T(0xDA, op_jp_cc)       X(0xDB, op_illegal) \
+        T(0xDC, op_call_cc)     X(0xDD, op_illegal)     X(0xDE, op_sbc_d8)      T(0xDF, op_rst) \
+        X(0xE0, op_ldh_a8_a)    T(0xE1, op_pop)         X(0xE2, op_ld_c_ind_a)  X(0xE3, op_illegal) \
+        X(0xE4, op_illegal)     T(0xE5, op_push)        X(0xE6, op_and_d8)      T(0xE7, op_rst) \
+        X(0xE8, op_add_sp_r8)   X(0xE9, op_jp_hl)       X(0xEA, op_ld_a16_a)    X(0xEB, op_illegal) \
+        X(0xEC, op_illegal)     X(0xED, op_illegal)     X(0xEE, op_xor_d8)      T(0xEF, op_rst) \
+        X(0xF0, op_ldh_a_a8)    T(0xF1, op_pop)         X(0xF2, op_ld_a_c_ind)  X(0xF3, op_di) \
+        X(0xF4, op_illegal)     T(0xF5, op_push)        X(0xF6, op_or_d8)       T(0xF7, op_rst) \
+        X(0xF8, op_ld_hl_sp_r8) X(0xF9, op_ld_sp_hl)    X(0xFA, op_ld_a_a16)    X(0xFB, op_ei) \
+        X(0xFC, op_illegal)     X(0xFD, op_illegal)     X(0xFE, op_cp_d8)       T(0xFF, op_rst)
+
+    static const OpHandler opcode_handlers[256];
+
+    // ===================== STEPPING ==========================
+
+    // Nothing but an event can raise an interrupt, so a halted CPU with none
+    // pending sleeps through to the next one. The jump is rounded up to whole
+    // 4-cycle HALT steps so the wake-up lands where single-stepping put it.
+    int halt_cycles() {
+        int cycles = ((int)scheduler.until_next() + 3) & ~3;
+        if (cycles < 4) cycles = 4;
+        cpu.halt_cycles_skipped += cycles - 4;
+        return cycles;
+    }
+
+    // Wakes the CPU from HALT and services the highest-priority pending
+    // interrupt. Returns true when the step was used up by HALT or the interrupt.
+    bool handle_interrupts() {
+        uint8_t pending = memory.read(0xFFFF) & memory.read(0xFF0F) & 0x1F;
+
+        if (cpu.halted) {
+            if (!pending) {
+                cpu.clock_cycles += halt_cycles();
+                return true;
+            }
+            cpu.halted = false;
+        }
+
+        if (!cpu.IME || !pending) return false;
+
+        int id = 0;
+        while (!(pending & (1 << id))) id++;
+
+        cpu.IME = false;
+        memory.write(0xFF0F, memory.read(0xFF0F) & ~(1 << id));
+        push16(cpu.PC);
+        cpu.PC = 0x0040 + id * 8;
+        cpu.clock_cycles += 20;
+        return true;
+    }
+
+    uint8_t fetch_opcode() {
+        uint8_t opcode = memory.read(cpu.PC);
+        if (cpu.halt_bug) cpu.halt_bug = false;
+        else cpu.PC++;
+        cpu.last_opcode = opcode;
+        return opcode;
+    }
+
+#ifdef GB_TRACE
+    void trace_instruction() {
+        uint8_t opcode = memory.read(cpu.PC);
+        const OpcodeInfo& info = opcode == 0xCB ? cbprefixed_table[memory.read(cpu.PC + 1)] : unprefixed_table[opcode];
+        printf("\nPC: %04X  %-4s %s%s%s  A: %02X  F: %02X  B: %02X  C: %02X  D: %02X  E: %02X  H: %02X  L: %02X  SP: %04X  IME: %d  IE: %02X  IF: %02X  LY: %02X\n",
+            cpu.PC, op_name(info.op), operand_name(info.operand1), info.operand2 != Opd::NONE ? "," : "", operand_name(info.operand2),
+            cpu.A, cpu.peekF(), cpu.B, cpu.C, cpu.D, cpu.E, cpu.H, cpu.L, cpu.STACK_P, cpu.IME,
+            memory.read(0xFFFF), memory.read(0xFF0F), memory.read(0xFF44));
+    }
+#endif
+
+#ifdef GB_LAZY_FLAGS_VERIFY
+    // Differential check between the lazy and eager flag paths. Uses peekF() so
+    // the pending lazy op is left in place for the next instruction to consume.
+    void verify_flags() {
+        if (cpu.peekF() != cpu.F_eager) {
+            printf("Lazy flags diverged after opcode 0x%02X (PC %04X): lazy %02X, eager %02X\n",
+                cpu.last_opcode, cpu.PC, cpu.peekF(), cpu.F_eager);
+            abort();
+        }
+    }
+#endif
+
+    // Handles every event that has come due, in the order the old
+    // per-instruction loop did: PPU catch-up, end of run, then HALT and
+    // interrupt entry, which take cycles of their own and so go round again.
+    // Returns false when the run should stop.
+    bool service_events() {
+        for (;;) {
+            if (scheduler.due(EVENT_PPU)) run_ppu_event();
+            if (scheduler.due(EVENT_OAM_DMA)) end_oam_dma();
+            if (scheduler.due(EVENT_RUN_END) || !running) return false;
+            if (!scheduler.due(EVENT_INTERRUPT)) return true;
+
+            scheduler.cancel(EVENT_INTERRUPT);
+            cpu.clock_cycles = 0;
+            if (!handle_interrupts()) return true;
+            scheduler.now += cpu.clock_cycles;
+            cpu.clock_cycles = 0;
+            // Still halted, or a handler was entered; look again afterwards
+            scheduler.schedule_now(EVENT_INTERRUPT);
+        }
+    }
+
+    // Every run starts with an interrupt check, as the CPU may have been
+    // halted or left with a pending interrupt at the end of the last one.
+    uint64_t begin_run(int budget) {
+        scheduler.schedule(EVENT_RUN_END, scheduler.now + budget);
+        scheduler.schedule_now(EVENT_INTERRUPT);
+        return scheduler.now;
+    }
+
+    int end_run(uint64_t start) {
+        scheduler.cancel(EVENT_RUN_END);
+        return (int)(scheduler.now - start);
+    }
+
+    // Executes one instruction and returns its T-cycle cost. HALT and
+    // interrupts are handled by service_events().
+    int cpu_step() {
+        cpu.clock_cycles = 0;
+
+#ifdef GB_TRACE
+        trace_instruction();
+#endif
+        bool enable_ime = cpu.IME_Pending;
+        uint8_t opcode = fetch_opcode();
+        (this->*opcode_handlers[opcode])(opcode);
+#ifdef GB_LAZY_FLAGS_VERIFY
+        verify_flags();
+#endif
+        if (enable_ime && cpu.IME_Pending) {
+            cpu.IME = true;
+            cpu.IME_Pending = false;
+            scheduler.schedule_now(EVENT_INTERRUPT);
+        }
+        cpu.instructions++;
+        return cpu.clock_cycles;
+    }
+
+    // Runs the CPU until at least `budget` T-cycles have elapsed or the
+    // emulator is stopped. Returns the number of cycles actually run. Between
+    // events the only per-instruction work is comparing `now` with `next`.
+#ifndef GB_COMPUTED_GOTO
+    int cpu_run(int budget) {
+        uint64_t start = begin_run(budget);
+        while (scheduler.now < scheduler.next || service_events())
+            scheduler.now += cpu_step();
+        return end_run(start);
+    }
+#else
+    // Kept out of line so the per-opcode copies of the dispatch sequence stay
+    // a handful of instructions long.
+    __attribute__((noinline, flatten)) bool between_instructions() {
+        return service_events();
+    }
+
+    int cpu_run(int budget) {
+#define GB_LABEL_ADDR(opcode, handler) &&op_label_##opcode,
+        static void* const labels[256] = { GB_OPCODE_LIST(GB_LABEL_ADDR, GB_LABEL_ADDR) };
+#undef GB_LABEL_ADDR
+
+        uint64_t start = begin_run(budget);
+        bool enable_ime = false;
+        uint8_t opcode;
+
+#ifdef GB_TRACE
+#define GB_TRACE_STEP() trace_instruction()
+#else
+#define GB_TRACE_STEP() ((void)0)
+#endif
+        // Each opcode body ends with its own copy of this, so the indirect jump
+        // to the next handler is predicted per opcode rather than from one site.
+#define GB_DISPATCH()                                   \
+        do {                                                \
+            GB_TRACE_STEP();                                \
+            enable_ime = cpu.IME_Pending;                   \
+            opcode = fetch_opcode();                        \
+            goto *labels[opcode];                           \
+        } while (0)
+
+#ifdef GB_LAZY_FLAGS_VERIFY
+#define GB_VERIFY_STEP() verify_flags()
+#else
+#define GB_VERIFY_STEP() ((void)0)
+#endif
+#define GB_LABEL_BODY(op, call)                         \
+        op_label_##op:                                      \
+            call;                                           \
+            GB_VERIFY_STEP();                               \
+            if (enable_ime && cpu.IME_Pending) {            \
+                cpu.IME = true;                             \
+                cpu.IME_Pending = false;                    \
+                scheduler.schedule_now(EVENT_INTERRUPT);    \
+            }                                               \
+            cpu.instructions++;                             \
+            scheduler.now += cpu.clock_cycles;              \
+            cpu.clock_cycles = 0;                           \
+            if (scheduler.now >= scheduler.next &&          \
+                !between_instructions())                    \
+                return end_run(start);                      \
+            GB_DISPATCH();
+#define GB_LABEL(op, handler) GB_LABEL_BODY(op, handler(op))
+#define GB_LABEL_T(op, handler) GB_LABEL_BODY(op, handler<op>(op))
+
+        cpu.clock_cycles = 0;
+        if (!between_instructions())
+            return end_run(start);
+        GB_DISPATCH();
+
+        GB_OPCODE_LIST(GB_LABEL, GB_LABEL_T)
+
+#undef GB_LABEL_T
+#undef GB_LABEL
+#undef GB_LABEL_BODY
+#undef GB_VERIFY_STEP
+#undef GB_DISPATCH
+#undef GB_TRACE_STEP
+        return end_run(start);
+    }
+#endif
+};
+
+#define GB_TABLE_ENTRY(opcode, handler) &Interpreter::handler,
+#define GB_TABLE_ENTRY_T(opcode, handler) &Interpreter::handler<opcode>,
+inline const Interpreter::OpHandler Interpreter::opcode_handlers[256] = { GB_OPCODE_LIST(GB_TABLE_ENTRY, GB_TABLE_ENTRY_T) };
+#undef GB_TABLE_ENTRY_T
+#undef GB_TABLE_ENTRY
+
+inline const std::array<Interpreter::OpHandler, 256> Interpreter::cb_handlers = Interpreter::make_cb_handlers(std::make_index_sequence<256>());
@@ -0,0 +1,426 @@
+#pragma once
+#include <stdio.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <tuple>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+#include "opcode_table.h"
+#include "interpreter.h"
+#include "block_cache.h"
+
+#if !defined(__x86_64__) && !defined(_M_X64)
+#error "GB_JIT needs an x86-64 host"
+#endif
+
+// x86-64 recompiler for hot blocks (GB_JIT).
+//
+// Blocks from the block cache that have been replayed JIT_THRESHOLD times are
+// translated into host code in an executable arena. Register loads, immediate
+// loads and unconditional JP/JR are emitted inline; every other instruction
+// becomes a call to its interpreter handler (through jit_call_op, since
+// handlers are member functions) with cpu.PC set up first, so the interpreter
+// stays the single definition of instruction semantics. Each machine has its
+// own arena, and its code has that machine's address baked in.
+//
+// Compiled blocks run without stopping: the cycles of the inlined
+// instructions and the instruction count are added at the block exit, and the
+// caller steps the PPU and checks interrupts once per block. A block that
+// writes over its own code leaves through an early exit after that write.
+//
+// GB_JIT_VERIFY runs every compiled block a second time through the
+// interpreter from a snapshot of the CPU and memory, and aborts if the two
+// disagree.
+
+constexpr uint32_t JIT_THRESHOLD = 32;
+constexpr size_t JIT_ARENA_SIZE = 4 << 20;
+constexpr size_t JIT_PAGE_SIZE = 4096;      // x86-64
+
+// Longest code jit_compile emits, from the sizes of the instruction forms
+// it uses (see X64Emitter). The exit adds the inlined cycles (10 bytes) and
+// the instruction count (11), drops the shadow space on Windows (4) and
+// pops rbx and returns (2). An instruction that calls its handler stores PC
+// (9), loads three 64-bit immediates for the call and one for the `valid`
+// check (40), calls (2), compares and branches (5) and has its own exit.
+// Inlined instructions are shorter (two 8-bit immediate stores, 14). The
+// prologue pushes rbx, makes the shadow space and loads rbx (15); the end
+// of the block may store PC before the final exit (9).
+constexpr size_t JIT_EXIT_CODE = 10 + 11 + 4 + 2;
+constexpr size_t JIT_MAX_OP_CODE = 9 + 40 + 2 + 5 + JIT_EXIT_CODE;
+constexpr size_t JIT_MAX_BLOCK_CODE = 15 + BLOCK_MAX_BYTES * JIT_MAX_OP_CODE + 9 + JIT_EXIT_CODE;
+static_assert(JIT_MAX_OP_CODE == 83, "per-instruction bound out of step with the emitted forms");
+static_assert(JIT_MAX_BLOCK_CODE < JIT_ARENA_SIZE, "a block must fit in an empty arena");
+
+// Minimal x86-64 encoder: just the instruction forms the JIT needs. Every
+// CPU field is addressed as [rbx + disp32] with rbx = &cpu of the machine
+// being compiled for. Nothing is written at or past `end`; running into it
+// sets `overflow` and the code is not to be used.
+struct X64Emitter {
+    uint8_t* p;
+    uint8_t* end;
+    bool overflow = false;
+
+    bool room(size_t n) {
+        if ((size_t)(end - p) >= n) return true;
+        overflow = true;
+        return false;
+    }
+    void u8(uint8_t v) { if (room(1)) *p++ = v; }
+    void u16(uint16_t v) { if (room(2)) { memcpy(p, &v, 2); p += 2; } }
+    void u32(uint32_t v) { if (room(4)) { memcpy(p, &v, 4); p += 4; } }
+    void u64(uint64_t v) { if (room(8)) { memcpy(p, &v, 8); p += 8; } }
+
+    void push_rbx() { u8(0x53); }
+    void pop_rbx() { u8(0x5B); }
+    void sub_rsp(uint8_t n) { u8(0x48); u8(0x83); u8(0xEC); u8(n); }
+    void add_rsp(uint8_t n) { u8(0x48); u8(0x83); u8(0xC4); u8(n); }
+    void ret() { u8(0xC3); }
+    void mov_rbx_imm64(const void* v) { u8(0x48); u8(0xBB); u64((uint64_t)(uintptr_t)v); }
+    void mov_rax_imm64(const void* v) { u8(0x48); u8(0xB8); u64((uint64_t)(uintptr_t)v); }
+    void call_rax() { u8(0xFF); u8(0xD0); }
+    // First two integer arguments: rdi, rsi on System V, rcx, rdx on Windows
+#ifdef _WIN32
+    void mov_arg0_imm64(const void* v) { u8(0x48); u8(0xB9); u64((uint64_t)(uintptr_t)v); }
+    void mov_arg1_imm64(const void* v) { u8(0x48); u8(0xBA); u64((uint64_t)(uintptr_t)v); }
+#else
+    void mov_arg0_imm64(const void* v) { u8(0x48); u8(0xBF); u64((uint64_t)(uintptr_t)v); }
+    void mov_arg1_imm64(const void* v) { u8(0x48); u8(0xBE); u64((uint64_t)(uintptr_t)v); }
+#endif
+    void mov_al_mem(int32_t disp) { u8(0x8A); u8(0x83); u32(disp); }
+    void mov_mem_al(int32_t disp) { u8(0x88); u8(0x83); u32(disp); }
+    void mov_mem8_imm(int32_t disp, uint8_t v) { u8(0xC6); u8(0x83); u32(disp); u8(v); }
+    void mov_mem16_imm(int32_t disp, uint16_t v) { u8(0x66); u8(0xC7); u8(0x83); u32(disp); u16(v); }
+    void add_mem32_imm(int32_t disp, int32_t v) { u8(0x81); u8(0x83); u32(disp); u32(v); }
+    void add_mem64_imm(int32_t disp, int32_t v) { u8(0x48); u8(0x81); u8(0x83); u32(disp); u32(v); }
+    void cmp_byte_rax_0() { u8(0x80); u8(0x38); u8(0x00); }
+    uint8_t* jne8() { u8(0x75); u8(0x00); return p - 1; }
+    void patch8(uint8_t* at) { if (!overflow) *at = (uint8_t)(p - at - 1); }
+};
+
+struct Jit {
+    uint8_t* arena = nullptr;
+    size_t used = 0;
+    bool disabled = false;
+
+    uint64_t compiled = 0;
+    uint64_t runs = 0;
+    uint64_t flushes = 0;
+
+    Jit() = default;
+    Jit(const Jit&) = delete;
+    Jit& operator=(const Jit&) = delete;
+
+    ~Jit() {
+        if (!arena) return;
+#ifdef _WIN32
+        VirtualFree(arena, 0, MEM_RELEASE);
+#else
+        munmap(arena, JIT_ARENA_SIZE);
+#endif
+    }
+
+    // The arena is never writable and executable at once. It starts out
+    // executable; the pages a block is compiled into are made writable for
+    // the compile and executable again right after.
+    bool init() {
+#ifdef _WIN32
+        arena = (uint8_t*)VirtualAlloc(nullptr, JIT_ARENA_SIZE, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READ);
+#else
+        void* mem = mmap(nullptr, JIT_ARENA_SIZE, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        arena = mem == MAP_FAILED ? nullptr : (uint8_t*)mem;
+#endif
+        if (!arena) {
+            printf("JIT: could not allocate executable memory, using the interpreter\n");
+            disabled = true;
+        }
+        return arena != nullptr;
+    }
+
+    // Makes the pages holding arena[from, to) writable (and not executable),
+    // or executable (and not writable) again
+    bool set_writable(size_t from, size_t to, bool writable) {
+        size_t first = from / JIT_PAGE_SIZE * JIT_PAGE_SIZE;
+        size_t last = std::min((to + JIT_PAGE_SIZE - 1) / JIT_PAGE_SIZE * JIT_PAGE_SIZE, JIT_ARENA_SIZE);
+#ifdef _WIN32
+        DWORD old;
+        bool ok = VirtualProtect(arena + first, last - first, writable ? PAGE_READWRITE : PAGE_EXECUTE_READ, &old) != 0;
+        if (ok && !writable) FlushInstructionCache(GetCurrentProcess(), arena + first, last - first);
+        return ok;
+#else
+        return mprotect(arena + first, last - first, writable ? PROT_READ | PROT_WRITE : PROT_READ | PROT_EXEC) == 0;
+#endif
+    }
+};
+
+// The block cache core with hot blocks compiled to host code
+struct JitCore : BlockCore {
+    Jit jit;
+
+    // Drops all compiled code. Blocks are recompiled once they get hot again.
+    void jit_flush() {
+        for (Block* block : block_cache.by_pc) {
+            if (!block) continue;
+            block->jit = nullptr;
+            block->jit_tried = false;
+        }
+        jit.used = 0;
+        jit.flushes++;
+    }
+
+    // Translates a block, returning false for blocks that stay interpreted
+    bool jit_compile(Block* block) {
+        block->jit_tried = true;
+        if (jit.disabled || (!jit.arena && !jit.init())) return false;
+        if (jit.used + JIT_MAX_BLOCK_CODE > JIT_ARENA_SIZE) jit_flush();
+
+        // EI enables IME after the following instruction, which only the
+        // per-instruction loop tracks
+        for (const MicroOp& op : block->ops)
+            if (op.skip == 1 && op.arg == 0xFB) return false;
+
+        size_t from = jit.used, to = std::min(from + JIT_MAX_BLOCK_CODE, JIT_ARENA_SIZE);
+        if (!jit.set_writable(from, to, true)) {
+            printf("JIT: could not write to the code arena, using the interpreter\n");
+            jit.disabled = true;
+            return false;
+        }
+        X64Emitter e{ jit.arena + from, jit.arena + to };
+        uint8_t* start = e.p;
+        const int32_t off_pc = field(&cpu.PC);
+
+        e.push_rbx();
+#ifdef _WIN32
+        e.sub_rsp(32);   // shadow space for the callees
+#endif
+        e.mov_rbx_imm64(&cpu);
+
+        int static_cycles = 0;    // cycles of inlined instructions not yet added
+        int done = 0;
+        bool pc_current = true;   // cpu.PC already points past the last instruction
+        uint16_t addr = block->start;
+
+        for (const MicroOp& op : block->ops) {
+            uint8_t opcode = op.skip == 2 ? 0xCB : op.arg;
+            const OpcodeInfo& info = unprefixed_table[opcode];
+            uint16_t next = addr + (op.skip == 2 ? 2 : info.length);
+
+            if (emit_inline(e, opcode, addr, next)) {
+                static_cycles += info.cycles[0];
+                pc_current = opcode == 0xC3 || opcode == 0x18;
+            }
+            else {
+                e.mov_mem16_imm(off_pc, addr + op.skip);
+                e.mov_arg0_imm64(this);
+                e.mov_arg1_imm64(&op);
+                e.mov_rax_imm64((const void*)&jit_call_op);
+                e.call_rax();
+                pc_current = true;
+
+                // Leave right away if the handler overwrote this block
+                e.mov_rax_imm64(&block->valid);
+                e.cmp_byte_rax_0();
+                uint8_t* skip_exit = e.jne8();
+                emit_exit(e, static_cycles, done + 1);
+                e.patch8(skip_exit);
+            }
+            done++;
+            addr = next;
+        }
+        if (!pc_current) e.mov_mem16_imm(off_pc, addr);
+        emit_exit(e, static_cycles, done);
+
+        jit.set_writable(from, to, false);
+        if (e.overflow) {
+            // Longer than JIT_MAX_BLOCK_CODE allows for: start over in an
+            // empty arena, or leave the block interpreted if even that is
+            // not enough
+            if (from == 0) return false;
+            jit_flush();
+            return jit_compile(block);
+        }
+        jit.used += e.p - start;
+        block->jit = (void (*)())start;
+        jit.compiled++;
+        return true;
+    }
+
+#ifdef GB_JIT_VERIFY
+    // Interpreter run of a block with the same boundaries as the compiled code:
+    // no PPU steps or interrupts in between.
+    void run_block_reference(Block* block) {
+        for (const MicroOp& op : block->ops) {
+            cpu.PC += op.skip;
+            cpu.last_opcode = op.skip == 2 ? 0xCB : op.arg;
+            (this->*op.handler)(op.arg);
+            cpu.instructions++;
+            if (!block->valid) return;
+        }
+    }
+
+    static bool same_cpu_state(const CPU& a, const CPU& b) {
+        return a.A == b.A && a.peekF() == b.peekF() && a.B == b.B && a.C == b.C && a.D == b.D &&
+            a.E == b.E && a.H == b.H && a.L == b.L && a.PC == b.PC && a.STACK_P == b.STACK_P &&
+            a.clock_cycles == b.clock_cycles && a.instructions == b.instructions && a.IME == b.IME &&
+            a.IME_Pending == b.IME_Pending && a.halted == b.halted && a.halt_bug == b.halt_bug;
+    }
+
+    // Runs the compiled block, then replays it through the interpreter from the
+    // same starting state and compares. Self-modifying blocks are not compared
+    // since the first run already changed the code the second would execute.
+    void run_jit_verified(Block* block) {
+        // Bring the PPU up to date first, so a register write inside the block
+        // does not sync it in one run and not the other
+        if (ppu_synced_at != scheduler.now) sync_ppu();
+        CPU start_cpu = cpu;
+        std::vector<uint8_t> start_memory = memory.data;
+        size_t start_vram_log = memory.vram_log ? memory.vram_log->size() : 0;
+        Cartridge& cart = memory.cart;
+        std::vector<uint8_t> start_cart_ram(cart.ram, cart.ram + cart.ram_size);
+        auto start_banks = std::make_tuple(cart.ram_enabled, cart.rom_bank, cart.bank_hi, cart.mbc1_mode);
+
+        block->jit();
+        if (!block->valid) return;
+
+        CPU jit_cpu = cpu;
+        std::vector<uint8_t> jit_memory = memory.data;
+        std::vector<uint8_t> jit_cart_ram(cart.ram, cart.ram + cart.ram_size);
+        cpu = start_cpu;
+        memory.data = start_memory;
+        // VRAM and OAM may have gone back
+        memory.vram.reindex();
+        if (memory.vram_log) memory.vram_log->resize(start_vram_log);
+        memory.index_sprites();
+        std::copy(start_cart_ram.begin(), start_cart_ram.end(), cart.ram);
+        std::tie(cart.ram_enabled, cart.rom_bank, cart.bank_hi, cart.mbc1_mode) = start_banks;
+        memory.map_cartridge();
+        run_block_reference(block);
+
+        if (!same_cpu_state(cpu, jit_cpu) || memory.data != jit_memory ||
+            !std::equal(jit_cart_ram.begin(), jit_cart_ram.end(), cart.ram)) {
+            printf("JIT mismatch in block %04X (%zu ops)\n", block->start, block->ops.size());
+            printf("  jit:    A=%02X F=%02X BC=%02X%02X DE=%02X%02X HL=%02X%02X SP=%04X PC=%04X cycles=%d\n",
+                jit_cpu.A, jit_cpu.peekF(), jit_cpu.B, jit_cpu.C, jit_cpu.D, jit_cpu.E, jit_cpu.H, jit_cpu.L,
+                jit_cpu.STACK_P, jit_cpu.PC, jit_cpu.clock_cycles);
+            printf("  interp: A=%02X F=%02X BC=%02X%02X DE=%02X%02X HL=%02X%02X SP=%04X PC=%04X cycles=%d\n",
+                cpu.A, cpu.peekF(), cpu.B, cpu.C, cpu.D, cpu.E, cpu.H, cpu.L,
+                cpu.STACK_P, cpu.PC, cpu.clock_cycles);
+            abort();
+        }
+    }
+#endif
+
+    // cpu_run_blocks() with hot blocks handed to the JIT. A block is entered
+    // through compiled code only when no EI is waiting to take effect, since the
+    // compiled code does not model the EI delay.
+    int cpu_run_jit(int budget) {
+        uint64_t start = begin_run(budget);
+        while (scheduler.now < scheduler.next || service_events()) {
+            if (cpu.halt_bug) {
+                scheduler.now += cpu_step();
+                continue;
+            }
+
+            Block* block = lookup_block(cpu.PC);
+            if (block->ops.empty()) {
+                scheduler.now += cpu_step();
+                continue;
+            }
+            if (run_fused(block)) continue;
+            if (!block->jit && !block->jit_tried && block->exec_count >= JIT_THRESHOLD)
+                jit_compile(block);
+            if (!block->jit || cpu.IME_Pending) {
+                run_block(block);
+                continue;
+            }
+
+            block->exec_count++;
+            jit.runs++;
+            cpu.clock_cycles = 0;
+#ifdef GB_JIT_VERIFY
+            run_jit_verified(block);
+#else
+            block->jit();
+#endif
+#ifdef GB_LAZY_FLAGS_VERIFY
+            verify_flags();
+#endif
+            scheduler.now += cpu.clock_cycles;
+        }
+        return end_run(start);
+    }
+
+private:
+    static void jit_call_op(JitCore* core, const MicroOp* op) {
+        (core->*op->handler)(op->arg);
+    }
+
+    int32_t field(const void* member) const {
+        return (int32_t)((const uint8_t*)member - (const uint8_t*)&cpu);
+    }
+
+    int32_t r8_field(int r) const {
+        switch (r) {
+        case 0: return field(&cpu.B);
+        case 1: return field(&cpu.C);
+        case 2: return field(&cpu.D);
+        case 3: return field(&cpu.E);
+        case 4: return field(&cpu.H);
+        case 5: return field(&cpu.L);
+        default: return field(&cpu.A);
+        }
+    }
+
+    void emit_exit(X64Emitter& e, int static_cycles, int instructions) {
+        if (static_cycles) e.add_mem32_imm(field(&cpu.clock_cycles), static_cycles);
+        e.add_mem64_imm(field(&cpu.instructions), instructions);
+#ifdef _WIN32
+        e.add_rsp(32);
+#endif
+        e.pop_rbx();
+        e.ret();
+    }
+
+    // Host code for instructions that only move registers or constants
+    // around. Returns false when the instruction needs its handler.
+    bool emit_inline(X64Emitter& e, uint8_t opcode, uint16_t addr, uint16_t next) {
+        if (opcode == 0x00) return true;
+        if (opcode >= 0x40 && opcode < 0x80 && opcode != 0x76) {
+            int dst = r8_dst(opcode), src = r8_src(opcode);
+            if (dst == 6 || src == 6) return false;
+            if (dst != src) {
+                e.mov_al_mem(r8_field(src));
+                e.mov_mem_al(r8_field(dst));
+            }
+            return true;
+        }
+        if (opcode < 0x40 && (opcode & 0x07) == 0x06 && opcode != 0x36) {
+            e.mov_mem8_imm(r8_field(r8_dst(opcode)), memory.read(addr + 1));
+            return true;
+        }
+        if (opcode < 0x40 && (opcode & 0x0F) == 0x01) {
+            uint8_t lo = memory.read(addr + 1), hi = memory.read(addr + 2);
+            switch (r16_field(opcode)) {
+            case 0: e.mov_mem8_imm(field(&cpu.B), hi); e.mov_mem8_imm(field(&cpu.C), lo); break;
+            case 1: e.mov_mem8_imm(field(&cpu.D), hi); e.mov_mem8_imm(field(&cpu.E), lo); break;
+            case 2: e.mov_mem8_imm(field(&cpu.H), hi); e.mov_mem8_imm(field(&cpu.L), lo); break;
+            default: e.mov_mem16_imm(field(&cpu.STACK_P), (hi << 8) | lo); break;
+            }
+            return true;
+        }
+        if (opcode == 0xC3) {
+            e.mov_mem16_imm(field(&cpu.PC), memory.read(addr + 1) | (memory.read(addr + 2) << 8));
+            return true;
+        }
+        if (opcode == 0x18) {
+            e.mov_mem16_imm(field(&cpu.PC), next + (int8_t)memory.read(addr + 1));
+            return true;
+        }
+        return false;
+    }
+};
@@ -0,0 +1,184 @@
+#pragma once
+#include <stdio.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include "tile_cache.h"
+#include "map_cache.h"
+#include "ppu_simd.h"
+#include "vram_index.h"
+
+// The four DMG shades, lightest first, as XRGB8888
+constexpr uint32_t DMG_SHADES[4] = { 0xFFFFFF, 0xAAAAAA, 0x555555, 0x000000 };
+
+// Everything drawing a line reads besides VRAM: the LCD registers as they
+// were when the PPU finished the line, and the OAM entries its OAM scan
+// picked, as they were then. The PPU records one per line (see
+// PPU::draw_line).
+struct LineState {
+    uint8_t ly;
+    uint8_t lcdc, scy, scx, wy, wx;
+    uint8_t palettes[3];            // BGP, OBP0, OBP1
+    uint8_t sprite_count;
+    uint8_t sprites[10][4];         // in drawing priority order
+    uint32_t vram_writes;           // render thread: logged VRAM writes that come before the line
+};
+
+// Counters of the tile cache and map layers, as printed with the MIPS figure
+struct RenderStats {
+    uint64_t tile_hits = 0, tile_decodes = 0;
+    uint64_t map_hits = 0, map_redraws = 0;
+};
+
+// Draws lines from their LineState and the VRAM behind `vram`, through the
+// tile cache and map layers kept over that VRAM
+struct LineRenderer {
+    VramIndex& vram;
+    TileCache tiles{ vram };
+    MapCache maps{ vram, tiles };
+    const LayerRenderer* layer_renderer = best_layer_renderer();
+
+    // BGP, OBP0 and OBP1 as the XRGB8888 pixel of each color number,
+    // rebuilt only when the register has changed
+    struct Palette {
+        int built_from = -1;    // register value, -1 before the first build
+        uint32_t colors[4];
+    };
+    Palette palettes[3];
+
+    explicit LineRenderer(VramIndex& vram) : vram(vram) {}
+    LineRenderer(const LineRenderer&) = delete;
+    LineRenderer& operator=(const LineRenderer&) = delete;
+
+    RenderStats stats() const {
+        RenderStats stats;
+        stats.tile_hits = tiles.hits;
+        stats.tile_decodes = tiles.decodes;
+        stats.map_hits = maps.hits;
+        stats.map_redraws = maps.redraws;
+        return stats;
+    }
+
+    // Pixels of palette 0 (BGP), 1 (OBP0) or 2 (OBP1) of a line
+    const uint32_t* palette(const LineState& line, int index) {
+        uint8_t value = line.palettes[index];
+        Palette& built = palettes[index];
+        if (built.built_from != value) {
+            built.built_from = value;
+            for (int i = 0; i < 4; i++) built.colors[i] = DMG_SHADES[(value >> (i * 2)) & 0x03];
+        }
+        return built.colors;
+    }
+
+    // Background, window and sprites of a line into its 160 pixels at `row`
+    void draw(const LineState& line, uint32_t* row) {
+        render_scanline(line, row);
+        render_window(line, row);
+        render_sprites(line, row);
+    }
+
+    void render_scanline(const LineState& line, uint32_t* row) {
+        const uint32_t* bgp = palette(line, 0);
+        uint8_t lcdc = line.lcdc;
+        if (!(lcdc & 0x01)) {
+            // Background off: the line is blank (white) under the window and sprites
+            std::fill(row, row + 160, DMG_SHADES[0]);
+            return;
+        }
+
+        int map = (lcdc & 0x08) ? 1 : 0;
+        bool signed_index = !(lcdc & 0x10);
+#ifdef GB_TRACE
+        printf("LCDC = 0x%02X | Tile data base = 0x%04X\n", lcdc, (lcdc & 0x10) ? 0x8000 : 0x8800);
+#endif
+        uint8_t pixel_y = (line.ly + line.scy) & 0xFF;
+        layer_renderer->draw(maps.line(map, signed_index, pixel_y), line.scx, 160, bgp, row);
+#ifdef GB_SIMD_VERIFY
+        verify_layer(line, map, signed_index, pixel_y, line.scx, 160, bgp, row);
+#endif
+#ifdef GB_TRACE
+        printf("rendered scanline - %d\n", line.ly);
+#endif
+    }
+
+    void render_window(const LineState& line, uint32_t* row) {
+        uint8_t lcdc = line.lcdc;
+        if (!(lcdc & 0x20)) return;
+
+        uint8_t wx = line.wx - 7;
+        uint8_t wy = line.wy;
+        const uint32_t* bgp = palette(line, 0);
+        if (line.ly < wy || wx >= 160) return;
+
+        int map = (lcdc & 0x40) ? 1 : 0;
+        bool signed_index = !(lcdc & 0x10);
+        uint8_t win_y = line.ly - wy;
+        layer_renderer->draw(maps.line(map, signed_index, win_y), 0, 160 - wx, bgp, row + wx);
+#ifdef GB_SIMD_VERIFY
+        verify_layer(line, map, signed_index, win_y, 0, 160 - wx, bgp, row + wx);
+#endif
+    }
+
+#ifdef GB_SIMD_VERIFY
+    // Decodes the pixels straight from the tile map and tile data, and
+    // aborts unless what was drawn, and what every kernel the host has
+    // draws from the map layer, match that
+    void verify_layer(const LineState& line, int map, bool signed_index, uint8_t y, uint8_t start, int count, const uint32_t* bgp, const uint32_t* drawn) {
+        const uint8_t* map_row = vram.bytes + 0x1800 + map * 0x400 + (y / 8) * 32;
+        uint32_t expected[160];
+        for (int x = 0; x < count; x++) {
+            uint8_t pixel_x = (start + x) & 0xFF;
+            const uint8_t* bytes = vram.bytes + TileCache::tile_number(map_row[pixel_x / 8], signed_index) * 16 + (y % 8) * 2;
+            int bit = 7 - (pixel_x & 7);
+            int color = ((bytes[1] >> bit) & 1) << 1 | ((bytes[0] >> bit) & 1);
+            expected[x] = DMG_SHADES[(line.palettes[0] >> (color * 2)) & 0x03];
+        }
+        check_layer("PPU", line, drawn, expected, count, map, y, start);
+
+        LayerRenderer renderers[3];
+        int n = layer_renderers(renderers);
+        for (int k = 0; k < n; k++) {
+            uint32_t actual[160];
+            renderers[k].draw(maps.pixels[map][y], start, count, bgp, actual);
+            check_layer(renderers[k].name, line, actual, expected, count, map, y, start);
+        }
+    }
+
+    void check_layer(const char* who, const LineState& line, const uint32_t* actual, const uint32_t* expected, int count, int map, int y, int start) {
+        for (int x = 0; x < count; x++) {
+            if (actual[x] == expected[x]) continue;
+            printf("SIMD VERIFY: %s drew %06X instead of %06X (LY %d, map %d line %d, start %d, pixel %d)\n",
+                who, actual[x], expected[x], line.ly, map, y, start, x);
+            abort();
+        }
+    }
+#endif
+
+    // Draws the sprites the OAM scan picked, lowest priority first so that
+    // the first opaque pixel in priority order ends up on top
+    void render_sprites(const LineState& line, uint32_t* row) {
+        int height = (line.lcdc & 0x04) ? 16 : 8;
+
+        for (int k = line.sprite_count - 1; k >= 0; --k) {
+            const uint8_t* sprite = line.sprites[k];
+            int x = sprite[1] - 8;
+            uint8_t tile_index = sprite[2];
+            uint8_t attr = sprite[3];
+
+            // Y or the height may have been changed since the scan
+            int sprite_line = line.ly + 16 - sprite[0];
+            if (sprite_line < 0 || sprite_line >= height) continue;
+            if (attr & 0x40) sprite_line = height - 1 - sprite_line;
+            const uint8_t* pixels = tiles.row(tile_index + sprite_line / 8, sprite_line % 8, attr & 0x20);
+            const uint32_t* obp = palette(line, attr & 0x10 ? 2 : 1);
+
+            for (int j = 0; j < 8; ++j) {
+                int pixel_x = x + j;
+                if (pixel_x < 0 || pixel_x >= 160) continue;
+                uint8_t color_id = pixels[j];
+                if (color_id == 0) continue;
+                row[pixel_x] = obp[color_id];
+            }
+        }
+    }
+};
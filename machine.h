@@ -0,0 +1,126 @@
+#pragma once
+#include <cstdint>
+#include "memory.h"
+#include "CPU.h"
+#include "PPU.h"
+#include "scheduler.h"
+
+// Everything one emulated Game Boy owns. Nothing here is global, so separate
+// machines can run in the same process (one per thread) without sharing
+// state. The execution layers in interpreter.h, block_cache.h and jit_x64.h
+// derive from this; GameBoy in gameboy.h is the type to instantiate.
+
+constexpr int OAM_DMA_CYCLES = 640;    // 160 M-cycles
+
+struct Machine {
+    Memory memory;
+    CPU cpu;
+    Framebuffer framebuffer = {};
+    PPU ppu{ memory, framebuffer };
+    Scheduler scheduler;
+    uint64_t ppu_synced_at = 0;     // scheduler.now the PPU has been stepped up to
+    uint64_t ppu_draws_at = 0;      // when the PPU next reads VRAM or OAM
+    uint64_t ppu_syncs = 0;         // times the PPU has been stepped
+    bool ppu_watched = false;       // LY or STAT is being read: step at every mode change
+    bool running = true;
+
+    Machine() {
+        memory.set_io_callback(0xFF0F, interrupt_register_written, this);
+        memory.set_io_callback(0xFFFF, interrupt_register_written, this);
+        for (uint16_t addr : { 0xFF40, 0xFF41, 0xFF45 })
+            memory.set_io_callback(addr, ppu_register_written, this);
+        for (uint16_t addr : { 0xFF42, 0xFF43, 0xFF47, 0xFF48, 0xFF49, 0xFF4A, 0xFF4B })
+            memory.set_io_callback(addr, ppu_state_written, this);
+        memory.set_io_callback(0xFF46, oam_dma_written, this);
+        memory.ppu_write_hook = catch_up_ppu;
+        memory.ppu_read_hook = ppu_register_read;
+        memory.ppu_context = this;
+        scheduler.schedule_now(EVENT_PPU);
+    }
+    Machine(const Machine&) = delete;
+    Machine& operator=(const Machine&) = delete;
+
+    // The PPU is stepped lazily. It books an event only for what the CPU
+    // would notice without touching PPU state (its interrupts and the end
+    // of the frame, see PPU::cycles_until_event) and otherwise catches up
+    // when the CPU reads LY or STAT or writes VRAM, OAM or an LCD register.
+    // Catching up draws the lines the PPU would have drawn by then, from
+    // the same VRAM and registers, so frames come out as if it had been
+    // stepped all along.
+
+    // Steps the PPU up to the current time and books its next event
+    void sync_ppu() {
+        int cycles = (int)(scheduler.now - ppu_synced_at);
+        ppu_synced_at = scheduler.now;
+        ppu.step(cycles);
+        ppu_syncs++;
+        ppu_draws_at = scheduler.now + ppu.cycles_until_draw();
+        scheduler.schedule(EVENT_PPU, scheduler.now + ppu.cycles_until_event(ppu_watched));
+    }
+
+    // EVENT_PPU. Once LY and STAT have gone a whole event unread the PPU
+    // goes back to booking only its interrupts.
+    void run_ppu_event() {
+        ppu_watched = memory.ppu_registers_read;
+        memory.ppu_registers_read = false;
+        sync_ppu();
+    }
+
+    // Before the CPU writes VRAM, OAM or a register the PPU only draws from,
+    // it draws the lines that come before the write (if it has got to one)
+    static void catch_up_ppu(void* context) {
+        Machine* machine = static_cast<Machine*>(context);
+        if (machine->scheduler.now >= machine->ppu_draws_at && machine->ppu_synced_at != machine->scheduler.now)
+            machine->sync_ppu();
+    }
+
+    static void ppu_state_written(void* context, uint16_t, uint8_t) {
+        catch_up_ppu(context);
+    }
+
+    // The first read of LY or STAT since the PPU's last event. The PPU
+    // catches up, then books every mode and line change for as long as the
+    // reads go on, so the registers stay current for a polling loop without
+    // a call per read (and an idle-loop skip, which runs to the next event,
+    // does not jump past a change).
+    static void ppu_register_read(void* context) {
+        Machine* machine = static_cast<Machine*>(context);
+        machine->memory.ppu_registers_read = true;
+        if (machine->ppu_watched) return;
+        machine->ppu_watched = true;
+        machine->sync_ppu();
+    }
+
+    // Before the CPU writes a register that changes the PPU's modes or STAT,
+    // the PPU catches up to the start of the writing instruction and runs
+    // again right after it, exactly as if it were still stepped after every
+    // instruction. Writes the PPU itself makes while syncing come back
+    // through here and are ignored since it is already up to date.
+    static void ppu_register_written(void* context, uint16_t, uint8_t) {
+        Machine* machine = static_cast<Machine*>(context);
+        if (machine->ppu_synced_at != machine->scheduler.now) machine->sync_ppu();
+        machine->scheduler.schedule_now(EVENT_PPU);
+    }
+
+    // DMA: the PPU catches up first since it reads OAM, then the transfer
+    // happens in one go. The 160 M-cycles it would take are a single
+    // scheduled event, at which OAM becomes accessible again.
+    static void oam_dma_written(void* context, uint16_t, uint8_t value) {
+        Machine* machine = static_cast<Machine*>(context);
+        catch_up_ppu(context);
+        machine->memory.oam_dma(value);
+        machine->scheduler.schedule(EVENT_OAM_DMA, machine->scheduler.now + OAM_DMA_CYCLES);
+    }
+
+    void end_oam_dma() {
+        scheduler.cancel(EVENT_OAM_DMA);
+        memory.oam_dma_active = false;
+    }
+
+    // IF or IE: an interrupt may have become serviceable. The PPU raises its
+    // interrupts in IF only at its own events, so it need not catch up.
+    static void interrupt_register_written(void* context, uint16_t, uint8_t) {
+        Machine* machine = static_cast<Machine*>(context);
+        machine->scheduler.schedule_now(EVENT_INTERRUPT);
+    }
+};
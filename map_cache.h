@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include "tile_cache.h"
+#include "vram_index.h"
+
+// Both 32x32 tile maps (9800, 9C00) drawn out as 256x256 color numbers, so
+// a background or window line is a wrapped copy out of one row here.
+//
+// VRAM writes mark what must be drawn again (VramIndex::map_dirty): an
+// entry when it is written, and whole lines of every map row using a tile
+// when the tile's data is written. line() redraws the marked entries of the
+// line asked for from the tile cache first. A map is drawn for one tile data
+// addressing mode at a time; switching LCDC bit 4 redraws it as it is used.
+struct MapCache {
+    VramIndex& vram;
+    TileCache& tiles;
+    uint8_t pixels[2][256][256];
+    bool signed_index[2] = {};
+
+    uint64_t hits = 0;          // lines used as they were
+    uint64_t redraws = 0;       // lines with entries drawn again first
+
+    MapCache(VramIndex& vram, TileCache& tiles) : vram(vram), tiles(tiles) {}
+    MapCache(const MapCache&) = delete;
+    MapCache& operator=(const MapCache&) = delete;
+
+    // Color numbers of pixel line `y` of map 0 (9800) or 1 (9C00)
+    const uint8_t* line(int map, bool signed_index, int y) {
+        if (signed_index != this->signed_index[map]) {
+            this->signed_index[map] = signed_index;
+            memset(vram.map_dirty[map], 0xFF, sizeof(vram.map_dirty[map]));
+        }
+        uint32_t& dirty = vram.map_dirty[map][y];
+        if (dirty) {
+            redraw(map, y, dirty);
+            dirty = 0;
+            redraws++;
+        }
+        else {
+            hits++;
+        }
+        return pixels[map][y];
+    }
+
+private:
+    void redraw(int map, int y, uint32_t entries) {
+        const uint8_t* map_row = vram.bytes + 0x1800 + map * 0x400 + (y / 8) * 32;
+        uint8_t* out = pixels[map][y];
+        for (; entries; entries &= entries - 1) {
+            int entry = VramIndex::lowest_bit(entries);
+            int tile = TileCache::tile_number(map_row[entry], signed_index[map]);
+            memcpy(out + entry * 8, tiles.row(tile, y % 8), 8);
+        }
+    }
+};
@@ -1,49 +1,449 @@
 #pragma once
+#include <stdio.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
 #include <vector>
+#include "cartridge.h"
+#include "vram_index.h"
 
+#if defined(_MSC_VER)
+#define GB_NOINLINE __declspec(noinline)
+#else
+#define GB_NOINLINE __attribute__((noinline))
+#endif
 
-
-
+// The 64 KB address space as 256 pages of 256 bytes. A page that is plain
+// memory has host pointers in read_map/write_map and is accessed with one
+// table index and one load; a null entry sends the access to that page's
+// handler instead. Handlers cover writes to the I/O page, OAM (with the
+// unusable FEA0-FEFF range; Y writes update the sprite line index), ROM
+// writes, writes to VRAM (which mark what the PPU's tile cache and map
+// layers must draw again, or are logged for the render thread), and any
+// RAM page holding decoded code, whose write pointer is withdrawn so stores
+// can invalidate the stale blocks.
+//
+// I/O writes are dispatched through the register table below. I/O reads
+// stay direct because write_io keeps every register's storage equal to
+// what a read returns (STAT and LY, which the PPU updates lazily, let it
+// catch up first: see read_data). Echo RAM (E000-FDFF) maps onto the same
+// storage as C000-DDFF.
+//
+// ROM (0000-7FFF) and external RAM (A000-BFFF) pages point into the
+// cartridge's images at its current banks. Writes to ROM go to the bank
+// controller, and a bank switch just remaps those pages. External RAM kept
+// in a save file takes its first write after each publish_save_writes
+// through a handler, which is how the save learns it is dirty.
 class Memory {
 public:
-    std::vector<uint8_t> data;
+    typedef uint8_t (Memory::*ReadHandler)(uint16_t addr) const;
+    typedef void (Memory::*WriteHandler)(uint16_t addr, uint8_t value);
+
+    std::vector<uint8_t> data = std::vector<uint8_t>(0x10000);     // backing store, indexed by canonical address
+    Cartridge cart;                // backs 0000-7FFF and A000-BFFF instead of `data`
     bool allow_rom_write = false;
 
+    uint8_t* read_map[256];
+    uint8_t* write_map[256];
+    ReadHandler read_handlers[256];
+    WriteHandler write_handlers[256];
+
+    // Number of decoded blocks covering each address. A write to a covered
+    // byte (or a bank switch under covered code) goes through code_write_hook
+    // so the block cache can drop the stale decode.
+    uint8_t code_map[0x10000] = {};
+    uint32_t code_bytes[256] = {};     // covered bytes per page, from code_map
+    void (*code_write_hook)(void* context, uint16_t first, uint16_t last) = nullptr;
+    void* code_write_context = nullptr;
+
+    // The PPU is only stepped when something could tell (see Machine). It
+    // catches up through ppu_write_hook before a CPU write to VRAM or OAM,
+    // and through ppu_read_hook before a CPU read of STAT or LY (read_data).
+    void (*ppu_write_hook)(void* context) = nullptr;
+    void (*ppu_read_hook)(void* context) = nullptr;
+    void* ppu_context = nullptr;
+    bool ppu_registers_read = false;    // set by ppu_read_hook; skip it until the PPU clears this
+
+    // ---- I/O registers ----
+    //
+    // One entry per register, FF00-FF7F and IE (at IO_IE). A CPU write
+    // changes only the bits in write_mask; bits in read_ones do not exist on
+    // the DMG and read as 1, so they are kept set in storage and reads need
+    // no table lookup. Registers a component must see written (it may have
+    // to catch up first, or the write has a side effect) have a callback,
+    // run before the store; only those pay for an indirect call. Write-only
+    // bits (sound) are stored as written, there being no APU to read them.
+    typedef void (*IoCallback)(void* context, uint16_t addr, uint8_t value);
+    struct IoRegister {
+        uint8_t write_mask = 0xFF;
+        uint8_t read_ones = 0x00;
+        IoCallback on_write = nullptr;
+        void* context = nullptr;
+    };
+    static constexpr int IO_IE = 0x80;
+    IoRegister io_registers[0x81];
+
+    // What the PPU's caches must draw again after VRAM writes. While the PPU
+    // renders on a thread of its own, VRAM writes are appended to vram_log
+    // for it instead, and this index is rebuilt when the thread stops.
+    VramIndex vram{ &data[0x8000] };
+    std::vector<VramWrite>* vram_log = nullptr;
+
+    // OAM entries by the screen lines they can appear on: bit i of
+    // sprite_lines[line] is set when entry i's Y puts the top of a 16-line
+    // sprite at most 15 lines above `line` (the PPU checks the real height).
+    // Kept current by OAM writes and DMA, so the PPU's OAM scan only looks
+    // at entries that may be on the line.
+    uint64_t sprite_lines[144] = {};
+
+    // OAM DMA in progress: the CPU reads FF from OAM and its writes are
+    // ignored (the rest of the bus conflict is not modelled)
+    bool oam_dma_active = false;
+
+    // While set, external RAM backed by a save file has no direct write
+    // pointer, so the first write since the last publish_save_writes goes
+    // through write_cart_ram and gets noticed.
+    bool save_armed = false;
 
     Memory() {
-        data.resize(0x10000); // 64 KB
+        init_io_registers();
+        for (int page = 0; page < 256; page++) map_page(page);
     }
+    Memory(const Memory&) = delete;
+    Memory& operator=(const Memory&) = delete;
+
     void set_allow_rom_write(bool value) {
         allow_rom_write = value;
     }
 
+    void set_io_callback(uint16_t addr, IoCallback on_write, void* context) {
+        IoRegister& reg = io_registers[io_index(addr)];
+        reg.on_write = on_write;
+        reg.context = context;
+    }
+
+    // Hardware-side store into a register (the PPU updating LY or STAT):
+    // no write mask and no callback
+    void set_io(uint16_t addr, uint8_t value) {
+        data[addr] = value | io_registers[io_index(addr)].read_ones;
+    }
+
+    // Replaces the cartridge and maps its first banks. `save_path` is where
+    // a battery-backed cart keeps its RAM ("" for none).
+    void load_cartridge(std::shared_ptr<const RomImage> image, const std::string& save_path = "") {
+        cart.load(std::move(image), save_path);
+        save_armed = cart.save != nullptr;
+        map_cartridge();
+    }
+
+    // Tells the save file about external RAM writes since the last call and
+    // rearms the write handler. Called once per run, so the atomic store and
+    // the handler cost at most once per frame.
+    void publish_save_writes() {
+        if (!cart.save || save_armed) return;
+        cart.save->mark_dirty();
+        save_armed = true;
+        map_cartridge();
+    }
+
+    // Repoints the ROM and external RAM pages after a bank switch. Blocks
+    // decoded from a page whose contents changed underneath are dropped.
+    void map_cartridge() {
+        for (int page = 0; page < 0xC0; page++) {
+            if (page == 0x80) page = 0xA0;
+            const uint8_t* before = read_map[page];
+            map_page(page);
+            if (before != read_map[page] && code_bytes[page])
+                invalidate_code((uint16_t)(page << 8), (uint16_t)((page << 8) | 0xFF));
+        }
+    }
+
+    void invalidate_code(uint16_t first, uint16_t last) {
+        if (code_write_hook) code_write_hook(code_write_context, first, last);
+    }
+
     uint8_t read(uint16_t addr) const {
-        if (addr == 0xFF0F) {
-            return data[addr] | 0xE0;
+        const uint8_t* page = read_map[addr >> 8];
+        if (page) return page[addr & 0xFF];
+        return read_slow(addr);
+    }
+
+    // A CPU data read. STAT and LY are the PPU's to update and it may be
+    // behind, so those two let it catch up first. Instruction fetches, which
+    // never come from there, use read().
+    uint8_t read_data(uint16_t addr) const {
+        if ((uint16_t)(addr - 0xFF41) < 4 && !ppu_registers_read) read_ppu_register(addr);
+        return read(addr);
+    }
+
+    void write(uint16_t addr, uint8_t value) {
+        uint8_t* page = write_map[addr >> 8];
+        if (page) page[addr & 0xFF] = value;
+        else write_slow(addr, value);
+    }
+
+    // Host pointers for `count` bytes from addr when the whole run is plain,
+    // code-free memory laid out contiguously, else nullptr. For bulk
+    // operations that must behave exactly like byte-by-byte guest accesses.
+    const uint8_t* direct_read(uint16_t addr, int count) const {
+        if (addr <= 0xFF44 && addr + count > 0xFF41) return nullptr;     // STAT/LY: see read_data
+        return direct_range(read_map, addr, count);
+    }
+    uint8_t* direct_write(uint16_t addr, int count) { return direct_range(write_map, addr, count); }
+
+    // ---- OAM DMA ----
+
+    // The whole 160-byte transfer at once, straight from the source page
+    // when it is plain memory; the caller times the busy window
+    void oam_dma(uint8_t source_page) {
+        uint16_t source = (uint16_t)(source_page << 8);
+        uint8_t* oam = &data[0xFE00];
+        if (code_bytes[0xFE]) invalidate_code(0xFE00, 0xFE9F);
+        if (const uint8_t* from = direct_read(source, 0xA0)) memcpy(oam, from, 0xA0);
+        else for (int i = 0; i < 0xA0; i++) oam[i] = read((uint16_t)(source + i));
+        oam_dma_active = true;
+        index_sprites();
+    }
+
+    // Index of the lowest set bit
+    static int lowest_bit(uint64_t mask) { return VramIndex::lowest_bit(mask); }
+
+    // ---- sprite line index ----
+
+    // Rebuilds sprite_lines from OAM
+    void index_sprites() {
+        memset(sprite_lines, 0, sizeof(sprite_lines));
+        for (int entry = 0; entry < 40; entry++) move_sprite(entry, 0, data[0xFE00 + entry * 4]);
+    }
+
+    // Moves an entry's bit from the lines under Y `old_y` to those under `new_y`
+    void move_sprite(int entry, uint8_t old_y, uint8_t new_y) {
+        uint64_t bit = 1ULL << entry;
+        for (int line = std::max(old_y - 16, 0); line < std::min<int>(old_y, 144); line++) sprite_lines[line] &= ~bit;
+        for (int line = std::max(new_y - 16, 0); line < std::min<int>(new_y, 144); line++) sprite_lines[line] |= bit;
+    }
+
+    // ---- decoded code tracking (block cache) ----
+
+    void add_code(uint16_t addr) {
+        code_map[addr]++;
+        if (code_bytes[addr >> 8]++ == 0) map_code_page(addr >> 8);
+    }
+
+    void remove_code(uint16_t addr) {
+        code_map[addr]--;
+        if (--code_bytes[addr >> 8] == 0) map_code_page(addr >> 8);
+    }
+
+private:
+    // Out of line so read() and write() stay small enough to inline everywhere
+    GB_NOINLINE uint8_t read_slow(uint16_t addr) const {
+        return (this->*read_handlers[addr >> 8])(addr);
+    }
+
+    GB_NOINLINE void write_slow(uint16_t addr, uint8_t value) {
+        (this->*write_handlers[addr >> 8])(addr, value);
+    }
+
+    GB_NOINLINE void read_ppu_register(uint16_t addr) const {
+        if ((addr == 0xFF41 || addr == 0xFF44) && ppu_read_hook) ppu_read_hook(ppu_context);
+    }
+
+    static bool is_echo(int page) { return page >= 0xE0 && page < 0xFE; }
+    static bool is_wram(int page) { return page >= 0xC0 && page < 0xDE; }
+
+    static uint8_t* direct_range(uint8_t* const* map, uint16_t addr, int count) {
+        if (addr + count > 0x10000) return nullptr;
+        int first = addr >> 8, last = (addr + count - 1) >> 8;
+        uint8_t* base = map[first];
+        if (!base) return nullptr;
+        for (int page = first + 1; page <= last; page++)
+            if (map[page] != base + ((page - first) << 8)) return nullptr;
+        return base + (addr & 0xFF);
+    }
+
+    // Sets up one page from its region, and withdraws the direct write
+    // pointer while the page or its echo alias holds decoded code
+    void map_page(int page) {
+        int canonical = is_echo(page) ? page - 0x20 : page;
+        uint8_t* host = &data[canonical << 8];
+        read_map[page] = host;
+        write_map[page] = host;
+        read_handlers[page] = nullptr;
+        write_handlers[page] = &Memory::write_code_page;
+
+        if (page < 0x80) {
+            // Never written through: ROM writes go to write_rom
+            size_t bank = page < 0x40 ? cart.rom0_bank() : cart.rom1_bank();
+            read_map[page] = const_cast<uint8_t*>(cart.rom_bank_data(bank) + ((page & 0x3F) << 8));
+            write_map[page] = nullptr;
+            write_handlers[page] = &Memory::write_rom;
         }
-        else {
-            return data[addr];
+        else if (page >= 0xA0 && page < 0xC0) {
+            size_t bank = cart.ram_offset();
+            if (bank == NO_RAM) {
+                read_map[page] = write_map[page] = nullptr;
+                read_handlers[page] = &Memory::read_no_ram;
+                write_handlers[page] = &Memory::write_no_ram;
+                return;
+            }
+            // RAM smaller than 8 KB repeats through the range
+            host = &cart.ram[(bank + ((page - 0xA0) << 8)) % cart.ram_size];
+            read_map[page] = host;
+            write_map[page] = code_bytes[page] || save_armed ? nullptr : host;
+            write_handlers[page] = &Memory::write_cart_ram;
+        }
+        else if (page == 0xFE) {
+            read_map[page] = write_map[page] = nullptr;
+            read_handlers[page] = &Memory::read_oam;
+            write_handlers[page] = &Memory::write_oam;
+        }
+        else if (page == 0xFF) {
+            write_map[page] = nullptr;
+            write_handlers[page] = &Memory::write_io;
+        }
+        else if (page >= 0x80 && page < 0xA0) {
+            write_map[page] = nullptr;
+            write_handlers[page] = &Memory::write_vram;
+        }
+        else if (code_bytes[page] || code_bytes[alias_page(page)]) {
+            write_map[page] = nullptr;
         }
     }
 
-    void write(uint16_t addr, uint8_t value) {
+    static int alias_page(int page) {
+        return is_echo(page) ? page - 0x20 : is_wram(page) ? page + 0x20 : page;
+    }
+
+    void map_code_page(int page) {
+        map_page(page);
+        if (alias_page(page) != page) map_page(alias_page(page));
+    }
+
+    // Drops decoded code at addr and at its echo alias
+    void invalidate_code_at(uint16_t addr) {
+        if (code_map[addr]) invalidate_code(addr, addr);
+        uint16_t alias = (uint16_t)((alias_page(addr >> 8) << 8) | (addr & 0xFF));
+        if (alias != addr && code_map[alias]) invalidate_code(alias, alias);
+    }
 
-        if (addr < 0x8000 && !allow_rom_write) {
+    void write_code_page(uint16_t addr, uint8_t value) {
+        invalidate_code_at(addr);
+        read_map[addr >> 8][addr & 0xFF] = value;
+    }
+
+    void write_vram(uint16_t addr, uint8_t value) {
+        if (ppu_write_hook) ppu_write_hook(ppu_context);
+        invalidate_code_at(addr);
+        if (vram_log) {
+            data[addr] = value;
+            vram_log->push_back({ addr, value });
+        }
+        else {
+            vram.write(addr, value);
+        }
+    }
+
+    // Patches a private copy of the ROM bank while allowed (test setup),
+    // else it is a bank controller register write
+    void write_rom(uint16_t addr, uint8_t value) {
+        if (!allow_rom_write) {
+            if (cart.mbc != Mbc::NONE) {
+                if (cart.write_register(addr, value)) map_cartridge();
+                return;
+            }
 
             printf(" ROM Write Attempt: Addr = 0x%04X, Value = 0x%02X\n", addr, value);
            
             return;
         }
-        else if (addr == 0xFF0F) {
-                 data[addr] = (value & 0x1F) | 0xE0;  // Only lower 5 bits are writable, upper bits always 1
-                  return;
+        invalidate_code_at(addr);
+        size_t bank = addr < 0x4000 ? cart.rom0_bank() : cart.rom1_bank();
+        bool first_patch = !cart.is_patched(bank);
+        cart.patch_bank(bank)[addr & 0x3FFF] = value;
+        if (first_patch) map_cartridge();
+    }
+
+    void write_cart_ram(uint16_t addr, uint8_t value) {
+        invalidate_code_at(addr);
+        read_map[addr >> 8][addr & 0xFF] = value;
+        if (save_armed) {
+            save_armed = false;
+            map_cartridge();
         }
-        else {
+    }
+
+    // A000-BFFF with RAM disabled, absent, or an MBC3 clock register selected
+    uint8_t read_no_ram(uint16_t) const { return 0xFF; }
+    void write_no_ram(uint16_t, uint8_t) {}
+
+    // FEA0-FEFF is unusable: reads as FF, writes are ignored. So is all of
+    // OAM while a DMA transfer runs.
+    uint8_t read_oam(uint16_t addr) const {
+        return addr < 0xFEA0 && !oam_dma_active ? data[addr] : 0xFF;
+    }
+
+    void write_oam(uint16_t addr, uint8_t value) {
+        if (addr >= 0xFEA0 || oam_dma_active) return;
+        if (ppu_write_hook) ppu_write_hook(ppu_context);
+        invalidate_code_at(addr);
+        if ((addr & 3) == 0 && data[addr] != value) move_sprite((addr - 0xFE00) >> 2, data[addr], value);
+        data[addr] = value;
+    }
+
+    static int io_index(uint16_t addr) { return addr == 0xFFFF ? IO_IE : addr - 0xFF00; }
+
+    // Page FF: the registers, plus HRAM (FF80-FFFE), which is plain memory
+    void write_io(uint16_t addr, uint8_t value) {
+        invalidate_code_at(addr);
+        if (addr >= 0xFF80 && addr != 0xFFFF) {
             data[addr] = value;
+            return;
         }
+        const IoRegister& reg = io_registers[io_index(addr)];
+        if (reg.on_write) reg.on_write(reg.context, addr, value);
+        data[addr] = (data[addr] & ~reg.write_mask) | (value & reg.write_mask) | reg.read_ones;
     }
 
+    // DIV: any write resets the divider
+    static void reset_on_write(void* context, uint16_t addr, uint8_t) {
+        static_cast<Memory*>(context)->data[addr] = 0x00;
+    }
 
-};
-extern Memory memory;
+    // DMG register layout. Registers not listed are plain read/write bytes.
+    void init_io_registers() {
+        auto define = [this](uint16_t addr, uint8_t write_mask, uint8_t read_ones) {
+            IoRegister& reg = io_registers[io_index(addr)];
+            reg.write_mask = write_mask;
+            reg.read_ones = read_ones;
+        };
+        // Unmapped on the DMG: read FF, writes ignored
+        for (uint16_t addr : { 0xFF03, 0xFF15, 0xFF1F }) define(addr, 0x00, 0xFF);
+        for (uint16_t addr = 0xFF08; addr <= 0xFF0E; addr++) define(addr, 0x00, 0xFF);
+        for (uint16_t addr = 0xFF27; addr <= 0xFF2F; addr++) define(addr, 0x00, 0xFF);
+        for (uint16_t addr = 0xFF4C; addr <= 0xFF7F; addr++) define(addr, 0x00, 0xFF);
+
+        define(0xFF00, 0x30, 0xCF);     // P1: select bits only; no buttons pressed
+        define(0xFF02, 0x81, 0x7E);     // SC
+        define(0xFF04, 0x00, 0x00);     // DIV
+        io_registers[io_index(0xFF04)].on_write = reset_on_write;
+        io_registers[io_index(0xFF04)].context = this;
+        define(0xFF07, 0x07, 0xF8);     // TAC
+        define(0xFF0F, 0x1F, 0xE0);     // IF
+        define(0xFF10, 0x7F, 0x80);     // NR10
+        define(0xFF1A, 0x80, 0x7F);     // NR30
+        define(0xFF1C, 0x60, 0x9F);     // NR32
+        define(0xFF20, 0x3F, 0xC0);     // NR41
+        define(0xFF23, 0xC0, 0x3F);     // NR44
+        define(0xFF26, 0x80, 0x70);     // NR52: channel status bits are read only
+        define(0xFF41, 0x78, 0x80);     // STAT: mode and LYC=LY bits are read only
+        define(0xFF44, 0x00, 0x00);     // LY: read only
 
+        for (int i = 0; i <= IO_IE; i++) {
+            uint16_t addr = i == IO_IE ? 0xFFFF : 0xFF00 + i;
+            data[addr] |= io_registers[i].read_ones;
+        }
+    }
+};
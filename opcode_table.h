@@ -0,0 +1,734 @@
+// Generated by gen_opcode_table.py from opcodes.json - do not edit by hand.
+#pragma once
+#include <cstdint>
+
+enum class Op : uint8_t {
+    INVALID,
+    ADC,
+    ADD,
+    AND,
+    BIT,
+    CALL,
+    CCF,
+    CP,
+    CPL,
+    DAA,
+    DEC,
+    DI,
+    EI,
+    HALT,
+    INC,
+    JP,
+    JR,
+    LD,
+    LDH,
+    NOP,
+    OR,
+    POP,
+    PREFIX,
+    PUSH,
+    RES,
+    RET,
+    RETI,
+    RL,
+    RLA,
+    RLC,
+    RLCA,
+    RR,
+    RRA,
+    RRC,
+    RRCA,
+    RST,
+    SBC,
+    SCF,
+    SET,
+    SLA,
+    SRA,
+    SRL,
+    STOP,
+    SUB,
+    SWAP,
+    XOR,
+};
+
+enum class Opd : uint8_t {
+    NONE,
+    A,
+    B,
+    C,
+    D,
+    E,
+    H,
+    L,
+    AF,
+    BC,
+    DE,
+    HL,
+    SP,
+    NZ,
+    Z,
+    NC,
+    BC_IND,
+    DE_IND,
+    HL_IND,
+    HLI_IND,
+    HLD_IND,
+    C_IND,
+    A8_IND,
+    A16_IND,
+    D8,
+    D16,
+    A16,
+    R8,
+    SP_R8,
+    RST_00,
+    RST_08,
+    RST_10,
+    RST_18,
+    RST_20,
+    RST_28,
+    RST_30,
+    RST_38,
+    N0,
+    N1,
+    N2,
+    N3,
+    N4,
+    N5,
+    N6,
+    N7,
+    CB,
+};
+
+// One decoded opcode. cycles[1] is the not-taken cost of conditional
+// instructions and 0 otherwise. flags_set/flags_clear are the F bits the
+// instruction forces to 1/0, flags_affected the bits it computes.
+struct OpcodeInfo {
+    Op op;
+    Opd operand1;
+    Opd operand2;
+    uint8_t length;
+    uint8_t cycles[2];
+    uint8_t flags_set;
+    uint8_t flags_clear;
+    uint8_t flags_affected;
+};
+
+constexpr const char* op_names[] = {
+    "???",
+    "ADC",
+    "ADD",
+    "AND",
+    "BIT",
+    "CALL",
+    "CCF",
+    "CP",
+    "CPL",
+    "DAA",
+    "DEC",
+    "DI",
+    "EI",
+    "HALT",
+    "INC",
+    "JP",
+    "JR",
+    "LD",
+    "LDH",
+    "NOP",
+    "OR",
+    "POP",
+    "PREFIX",
+    "PUSH",
+    "RES",
+    "RET",
+    "RETI",
+    "RL",
+    "RLA",
+    "RLC",
+    "RLCA",
+    "RR",
+    "RRA",
+    "RRC",
+    "RRCA",
+    "RST",
+    "SBC",
+    "SCF",
+    "SET",
+    "SLA",
+    "SRA",
+    "SRL",
+    "STOP",
+    "SUB",
+    "SWAP",
+    "XOR",
+};
+
+constexpr const char* operand_names[] = {
+    "",
+    "A",
+    "B",
+    "C",
+    "D",
+    "E",
+    "H",
+    "L",
+    "AF",
+    "BC",
+    "DE",
+    "HL",
+    "SP",
+    "NZ",
+    "Z",
+    "NC",
+    "(BC)",
+    "(DE)",
+    "(HL)",
+    "(HL+)",
+    "(HL-)",
+    "(C)",
+    "(a8)",
+    "(a16)",
+    "d8",
+    "d16",
+    "a16",
+    "r8",
+    "SP+r8",
+    "00H",
+    "08H",
+    "10H",
+    "18H",
+    "20H",
+    "28H",
+    "30H",
+    "38H",
+    "0",
+    "1",
+    "2",
+    "3",
+    "4",
+    "5",
+    "6",
+    "7",
+    "CB",
+};
+
+constexpr const char* op_name(Op op) { return op_names[static_cast<int>(op)]; }
+constexpr const char* operand_name(Opd opd) { return operand_names[static_cast<int>(opd)]; }
+
+constexpr OpcodeInfo unprefixed_table[256] = {
+    { Op::NOP, Opd::NONE, Opd::NONE, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x00 NOP
+    { Op::LD, Opd::BC, Opd::D16, 3, { 12, 0 }, 0x00, 0x00, 0x00 }, // 0x01 LD BC,d16
+    { Op::LD, Opd::BC_IND, Opd::A, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x02 LD (BC),A
+    { Op::INC, Opd::BC, Opd::NONE, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x03 INC BC
+    { Op::INC, Opd::B, Opd::NONE, 1, { 4, 0 }, 0x00, 0x40, 0xA0 }, // 0x04 INC B
+    { Op::DEC, Opd::B, Opd::NONE, 1, { 4, 0 }, 0x40, 0x00, 0xA0 }, // 0x05 DEC B
+    { Op::LD, Opd::B, Opd::D8, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x06 LD B,d8
+    { Op::RLCA, Opd::NONE, Opd::NONE, 1, { 4, 0 }, 0x00, 0xE0, 0x10 }, // 0x07 RLCA
+    { Op::LD, Opd::A16_IND, Opd::SP, 3, { 20, 0 }, 0x00, 0x00, 0x00 }, // 0x08 LD (a16),SP
+    { Op::ADD, Opd::HL, Opd::BC, 1, { 8, 0 }, 0x00, 0x40, 0x30 }, // 0x09 ADD HL,BC
+    { Op::LD, Opd::A, Opd::BC_IND, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x0A LD A,(BC)
+    { Op::DEC, Opd::BC, Opd::NONE, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x0B DEC BC
+    { Op::INC, Opd::C, Opd::NONE, 1, { 4, 0 }, 0x00, 0x40, 0xA0 }, // 0x0C INC C
+    { Op::DEC, Opd::C, Opd::NONE, 1, { 4, 0 }, 0x40, 0x00, 0xA0 }, // 0x0D DEC C
+    { Op::LD, Opd::C, Opd::D8, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x0E LD C,d8
+    { Op::RRCA, Opd::NONE, Opd::NONE, 1, { 4, 0 }, 0x00, 0xE0, 0x10 }, // 0x0F RRCA
+    { Op::STOP, Opd::N0, Opd::NONE, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x10 STOP 0
+    { Op::LD, Opd::DE, Opd::D16, 3, { 12, 0 }, 0x00, 0x00, 0x00 }, // 0x11 LD DE,d16
+    { Op::LD, Opd::DE_IND, Opd::A, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x12 LD (DE),A
+    { Op::INC, Opd::DE, Opd::NONE, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x13 INC DE
+    { Op::INC, Opd::D, Opd::NONE, 1, { 4, 0 }, 0x00, 0x40, 0xA0 }, // 0x14 INC D
+    { Op::DEC, Opd::D, Opd::NONE, 1, { 4, 0 }, 0x40, 0x00, 0xA0 }, // 0x15 DEC D
+    { Op::LD, Opd::D, Opd::D8, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x16 LD D,d8
+    { Op::RLA, Opd::NONE, Opd::NONE, 1, { 4, 0 }, 0x00, 0xE0, 0x10 }, // 0x17 RLA
+    { Op::JR, Opd::R8, Opd::NONE, 2, { 12, 0 }, 0x00, 0x00, 0x00 }, // 0x18 JR r8
+    { Op::ADD, Opd::HL, Opd::DE, 1, { 8, 0 }, 0x00, 0x40, 0x30 }, // 0x19 ADD HL,DE
+    { Op::LD, Opd::A, Opd::DE_IND, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x1A LD A,(DE)
+    { Op::DEC, Opd::DE, Opd::NONE, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x1B DEC DE
+    { Op::INC, Opd::E, Opd::NONE, 1, { 4, 0 }, 0x00, 0x40, 0xA0 }, // 0x1C INC E
+    { Op::DEC, Opd::E, Opd::NONE, 1, { 4, 0 }, 0x40, 0x00, 0xA0 }, // 0x1D DEC E
+    { Op::LD, Opd::E, Opd::D8, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x1E LD E,d8
+    { Op::RRA, Opd::NONE, Opd::NONE, 1, { 4, 0 }, 0x00, 0xE0, 0x10 }, // 0x1F RRA
+    { Op::JR, Opd::NZ, Opd::R8, 2, { 12, 8 }, 0x00, 0x00, 0x00 }, // 0x20 JR NZ,r8
+    { Op::LD, Opd::HL, Opd::D16, 3, { 12, 0 }, 0x00, 0x00, 0x00 }, // 0x21 LD HL,d16
+    { Op::LD, Opd::HLI_IND, Opd::A, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x22 LD (HL+),A
+    { Op::INC, Opd::HL, Opd::NONE, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x23 INC HL
+    { Op::INC, Opd::H, Opd::NONE, 1, { 4, 0 }, 0x00, 0x40, 0xA0 }, // 0x24 INC H
+    { Op::DEC, Opd::H, Opd::NONE, 1, { 4, 0 }, 0x40, 0x00, 0xA0 }, // 0x25 DEC H
+    { Op::LD, Opd::H, Opd::D8, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x26 LD H,d8
+    { Op::DAA, Opd::NONE, Opd::NONE, 1, { 4, 0 }, 0x00, 0x20, 0x90 }, // 0x27 DAA
+    { Op::JR, Opd::Z, Opd::R8, 2, { 12, 8 }, 0x00, 0x00, 0x00 }, // 0x28 JR Z,r8
+    { Op::ADD, Opd::HL, Opd::HL, 1, { 8, 0 }, 0x00, 0x40, 0x30 }, // 0x29 ADD HL,HL
+    { Op::LD, Opd::A, Opd::HLI_IND, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x2A LD A,(HL+)
+    { Op::DEC, Opd::HL, Opd::NONE, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x2B DEC HL
+    { Op::INC, Opd::L, Opd::NONE, 1, { 4, 0 }, 0x00, 0x40, 0xA0 }, // 0x2C INC L
+    { Op::DEC, Opd::L, Opd::NONE, 1, { 4, 0 }, 0x40, 0x00, 0xA0 }, // 0x2D DEC L
+    { Op::LD, Opd::L, Opd::D8, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x2E LD L,d8
+    { Op::CPL, Opd::NONE, Opd::NONE, 1, { 4, 0 }, 0x60, 0x00, 0x00 }, // 0x2F CPL
+    { Op::JR, Opd::NC, Opd::R8, 2, { 12, 8 }, 0x00, 0x00, 0x00 }, // 0x30 JR NC,r8
+    { Op::LD, Opd::SP, Opd::D16, 3, { 12, 0 }, 0x00, 0x00, 0x00 }, // 0x31 LD SP,d16
+    { Op::LD, Opd::HLD_IND, Opd::A, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x32 LD (HL-),A
+    { Op::INC, Opd::SP, Opd::NONE, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x33 INC SP
+    { Op::INC, Opd::HL_IND, Opd::NONE, 1, { 12, 0 }, 0x00, 0x40, 0xA0 }, // 0x34 INC (HL)
+    { Op::DEC, Opd::HL_IND, Opd::NONE, 1, { 12, 0 }, 0x40, 0x00, 0xA0 }, // 0x35 DEC (HL)
+    { Op::LD, Opd::HL_IND, Opd::D8, 2, { 12, 0 }, 0x00, 0x00, 0x00 }, // 0x36 LD (HL),d8
+    { Op::SCF, Opd::NONE, Opd::NONE, 1, { 4, 0 }, 0x10, 0x60, 0x00 }, // 0x37 SCF
+    { Op::JR, Opd::C, Opd::R8, 2, { 12, 8 }, 0x00, 0x00, 0x00 }, // 0x38 JR C,r8
+    { Op::ADD, Opd::HL, Opd::SP, 1, { 8, 0 }, 0x00, 0x40, 0x30 }, // 0x39 ADD HL,SP
+    { Op::LD, Opd::A, Opd::HLD_IND, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x3A LD A,(HL-)
+    { Op::DEC, Opd::SP, Opd::NONE, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x3B DEC SP
+    { Op::INC, Opd::A, Opd::NONE, 1, { 4, 0 }, 0x00, 0x40, 0xA0 }, // 0x3C INC A
+    { Op::DEC, Opd::A, Opd::NONE, 1, { 4, 0 }, 0x40, 0x00, 0xA0 }, // 0x3D DEC A
+    { Op::LD, Opd::A, Opd::D8, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x3E LD A,d8
+    { Op::CCF, Opd::NONE, Opd::NONE, 1, { 4, 0 }, 0x00, 0x60, 0x10 }, // 0x3F CCF
+    { Op::LD, Opd::B, Opd::B, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x40 LD B,B
+    { Op::LD, Opd::B, Opd::C, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x41 LD B,C
+    { Op::LD, Opd::B, Opd::D, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x42 LD B,D
+    { Op::LD, Opd::B, Opd::E, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x43 LD B,E
+    { Op::LD, Opd::B, Opd::H, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x44 LD B,H
+    { Op::LD, Opd::B, Opd::L, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x45 LD B,L
+    { Op::LD, Opd::B, Opd::HL_IND, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x46 LD B,(HL)
+    { Op::LD, Opd::B, Opd::A, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x47 LD B,A
+    { Op::LD, Opd::C, Opd::B, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x48 LD C,B
+    { Op::LD, Opd::C, Opd::C, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x49 LD C,C
+    { Op::LD, Opd::C, Opd::D, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x4A LD C,D
+    { Op::LD, Opd::C, Opd::E, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x4B LD C,E
+    { Op::LD, Opd::C, Opd::H, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x4C LD C,H
+    { Op::LD, Opd::C, Opd::L, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x4D LD C,L
+    { Op::LD, Opd::C, Opd::HL_IND, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x4E LD C,(HL)
+    { Op::LD, Opd::C, Opd::A, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x4F LD C,A
+    { Op::LD, Opd::D, Opd::B, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x50 LD D,B
+    { Op::LD, Opd::D, Opd::C, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x51 LD D,C
+    { Op::LD, Opd::D, Opd::D, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x52 LD D,D
+    { Op::LD, Opd::D, Opd::E, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x53 LD D,E
+    { Op::LD, Opd::D, Opd::H, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x54 LD D,H
+    { Op::LD, Opd::D, Opd::L, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x55 LD D,L
+    { Op::LD, Opd::D, Opd::HL_IND, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x56 LD D,(HL)
+    { Op::LD, Opd::D, Opd::A, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x57 LD D,A
+    { Op::LD, Opd::E, Opd::B, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x58 LD E,B
+    { Op::LD, Opd::E, Opd::C, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x59 LD E,C
+    { Op::LD, Opd::E, Opd::D, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x5A LD E,D
+    { Op::LD, Opd::E, Opd::E, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x5B LD E,E
+    { Op::LD, Opd::E, Opd::H, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x5C LD E,H
+    { Op::LD, Opd::E, Opd::L, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x5D LD E,L
+    { Op::LD, Opd::E, Opd::HL_IND, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x5E LD E,(HL)
+    { Op::LD, Opd::E, Opd::A, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x5F LD E,A
+    { Op::LD, Opd::H, Opd::B, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x60 LD H,B
+    { Op::LD, Opd::H, Opd::C, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x61 LD H,C
+    { Op::LD, Opd::H, Opd::D, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x62 LD H,D
+    { Op::LD, Opd::H, Opd::E, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x63 LD H,E
+    { Op::LD, Opd::H, Opd::H, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x64 LD H,H
+    { Op::LD, Opd::H, Opd::L, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x65 LD H,L
+    { Op::LD, Opd::H, Opd::HL_IND, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x66 LD H,(HL)
+    { Op::LD, Opd::H, Opd::A, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x67 LD H,A
+    { Op::LD, Opd::L, Opd::B, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x68 LD L,B
+    { Op::LD, Opd::L, Opd::C, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x69 LD L,C
+    { Op::LD, Opd::L, Opd::D, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x6A LD L,D
+    { Op::LD, Opd::L, Opd::E, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x6B LD L,E
+    { Op::LD, Opd::L, Opd::H, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x6C LD L,H
+    { Op::LD, Opd::L, Opd::L, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x6D LD L,L
+    { Op::LD, Opd::L, Opd::HL_IND, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x6E LD L,(HL)
+    { Op::LD, Opd::L, Opd::A, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x6F LD L,A
+    { Op::LD, Opd::HL_IND, Opd::B, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x70 LD (HL),B
+    { Op::LD, Opd::HL_IND, Opd::C, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x71 LD (HL),C
+    { Op::LD, Opd::HL_IND, Opd::D, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x72 LD (HL),D
+    { Op::LD, Opd::HL_IND, Opd::E, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x73 LD (HL),E
+    { Op::LD, Opd::HL_IND, Opd::H, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x74 LD (HL),H
+    { Op::LD, Opd::HL_IND, Opd::L, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x75 LD (HL),L
+    { Op::HALT, Opd::NONE, Opd::NONE, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x76 HALT
+    { Op::LD, Opd::HL_IND, Opd::A, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x77 LD (HL),A
+    { Op::LD, Opd::A, Opd::B, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x78 LD A,B
+    { Op::LD, Opd::A, Opd::C, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x79 LD A,C
+    { Op::LD, Opd::A, Opd::D, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x7A LD A,D
+    { Op::LD, Opd::A, Opd::E, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x7B LD A,E
+    { Op::LD, Opd::A, Opd::H, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x7C LD A,H
+    { Op::LD, Opd::A, Opd::L, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x7D LD A,L
+    { Op::LD, Opd::A, Opd::HL_IND, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x7E LD A,(HL)
+    { Op::LD, Opd::A, Opd::A, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0x7F LD A,A
+    { Op::ADD, Opd::A, Opd::B, 1, { 4, 0 }, 0x00, 0x40, 0xB0 }, // 0x80 ADD A,B
+    { Op::ADD, Opd::A, Opd::C, 1, { 4, 0 }, 0x00, 0x40, 0xB0 }, // 0x81 ADD A,C
+    { Op::ADD, Opd::A, Opd::D, 1, { 4, 0 }, 0x00, 0x40, 0xB0 }, // 0x82 ADD A,D
+    { Op::ADD, Opd::A, Opd::E, 1, { 4, 0 }, 0x00, 0x40, 0xB0 }, // 0x83 ADD A,E
+    { Op::ADD, Opd::A, Opd::H, 1, { 4, 0 }, 0x00, 0x40, 0xB0 }, // 0x84 ADD A,H
+    { Op::ADD, Opd::A, Opd::L, 1, { 4, 0 }, 0x00, 0x40, 0xB0 }, // 0x85 ADD A,L
+    { Op::ADD, Opd::A, Opd::HL_IND, 1, { 8, 0 }, 0x00, 0x40, 0xB0 }, // 0x86 ADD A,(HL)
+    { Op::ADD, Opd::A, Opd::A, 1, { 4, 0 }, 0x00, 0x40, 0xB0 }, // 0x87 ADD A,A
+    { Op::ADC, Opd::A, Opd::B, 1, { 4, 0 }, 0x00, 0x40, 0xB0 }, // 0x88 ADC A,B
+    { Op::ADC, Opd::A, Opd::C, 1, { 4, 0 }, 0x00, 0x40, 0xB0 }, // 0x89 ADC A,C
+    { Op::ADC, Opd::A, Opd::D, 1, { 4, 0 }, 0x00, 0x40, 0xB0 }, // 0x8A ADC A,D
+    { Op::ADC, Opd::A, Opd::E, 1, { 4, 0 }, 0x00, 0x40, 0xB0 }, // 0x8B ADC A,E
+    { Op::ADC, Opd::A, Opd::H, 1, { 4, 0 }, 0x00, 0x40, 0xB0 }, // 0x8C ADC A,H
+    { Op::ADC, Opd::A, Opd::L, 1, { 4, 0 }, 0x00, 0x40, 0xB0 }, // 0x8D ADC A,L
+    { Op::ADC, Opd::A, Opd::HL_IND, 1, { 8, 0 }, 0x00, 0x40, 0xB0 }, // 0x8E ADC A,(HL)
+    { Op::ADC, Opd::A, Opd::A, 1, { 4, 0 }, 0x00, 0x40, 0xB0 }, // 0x8F ADC A,A
+    { Op::SUB, Opd::B, Opd::NONE, 1, { 4, 0 }, 0x40, 0x00, 0xB0 }, // 0x90 SUB B
+    { Op::SUB, Opd::C, Opd::NONE, 1, { 4, 0 }, 0x40, 0x00, 0xB0 }, // 0x91 SUB C
+    { Op::SUB, Opd::D, Opd::NONE, 1, { 4, 0 }, 0x40, 0x00, 0xB0 }, // 0x92 SUB D
+    { Op::SUB, Opd::E, Opd::NONE, 1, { 4, 0 }, 0x40, 0x00, 0xB0 }, // 0x93 SUB E
+    { Op::SUB, Opd::H, Opd::NONE, 1, { 4, 0 }, 0x40, 0x00, 0xB0 }, // 0x94 SUB H
+    { Op::SUB, Opd::L, Opd::NONE, 1, { 4, 0 }, 0x40, 0x00, 0xB0 }, // 0x95 SUB L
+    { Op::SUB, Opd::HL_IND, Opd::NONE, 1, { 8, 0 }, 0x40, 0x00, 0xB0 }, // 0x96 SUB (HL)
+    { Op::SUB, Opd::A, Opd::NONE, 1, { 4, 0 }, 0x40, 0x00, 0xB0 }, // 0x97 SUB A
+    { Op::SBC, Opd::A, Opd::B, 1, { 4, 0 }, 0x40, 0x00, 0xB0 }, // 0x98 SBC A,B
+    { Op::SBC, Opd::A, Opd::C, 1, { 4, 0 }, 0x40, 0x00, 0xB0 }, // 0x99 SBC A,C
+    { Op::SBC, Opd::A, Opd::D, 1, { 4, 0 }, 0x40, 0x00, 0xB0 }, // 0x9A SBC A,D
+    { Op::SBC, Opd::A, Opd::E, 1, { 4, 0 }, 0x40, 0x00, 0xB0 }, // 0x9B SBC A,E
+    { Op::SBC, Opd::A, Opd::H, 1, { 4, 0 }, 0x40, 0x00, 0xB0 }, // 0x9C SBC A,H
+    { Op::SBC, Opd::A, Opd::L, 1, { 4, 0 }, 0x40, 0x00, 0xB0 }, // 0x9D SBC A,L
+    { Op::SBC, Opd::A, Opd::HL_IND, 1, { 8, 0 }, 0x40, 0x00, 0xB0 }, // 0x9E SBC A,(HL)
+    { Op::SBC, Opd::A, Opd::A, 1, { 4, 0 }, 0x40, 0x00, 0xB0 }, // 0x9F SBC A,A
+    { Op::AND, Opd::B, Opd::NONE, 1, { 4, 0 }, 0x20, 0x50, 0x80 }, // 0xA0 AND B
+    { Op::AND, Opd::C, Opd::NONE, 1, { 4, 0 }, 0x20, 0x50, 0x80 }, // 0xA1 AND C
+    { Op::AND, Opd::D, Opd::NONE, 1, { 4, 0 }, 0x20, 0x50, 0x80 }, // 0xA2 AND D
+    { Op::AND, Opd::E, Opd::NONE, 1, { 4, 0 }, 0x20, 0x50, 0x80 }, // 0xA3 AND E
+    { Op::AND, Opd::H, Opd::NONE, 1, { 4, 0 }, 0x20, 0x50, 0x80 }, // 0xA4 AND H
+    { Op::AND, Opd::L, Opd::NONE, 1, { 4, 0 }, 0x20, 0x50, 0x80 }, // 0xA5 AND L
+    { Op::AND, Opd::HL_IND, Opd::NONE, 1, { 8, 0 }, 0x20, 0x50, 0x80 }, // 0xA6 AND (HL)
+    { Op::AND, Opd::A, Opd::NONE, 1, { 4, 0 }, 0x20, 0x50, 0x80 }, // 0xA7 AND A
+    { Op::XOR, Opd::B, Opd::NONE, 1, { 4, 0 }, 0x00, 0x70, 0x80 }, // 0xA8 XOR B
+    { Op::XOR, Opd::C, Opd::NONE, 1, { 4, 0 }, 0x00, 0x70, 0x80 }, // 0xA9 XOR C
+    { Op::XOR, Opd::D, Opd::NONE, 1, { 4, 0 }, 0x00, 0x70, 0x80 }, // 0xAA XOR D
+    { Op::XOR, Opd::E, Opd::NONE, 1, { 4, 0 }, 0x00, 0x70, 0x80 }, // 0xAB XOR E
+    { Op::XOR, Opd::H, Opd::NONE, 1, { 4, 0 }, 0x00, 0x70, 0x80 }, // 0xAC XOR H
+    { Op::XOR, Opd::L, Opd::NONE, 1, { 4, 0 }, 0x00, 0x70, 0x80 }, // 0xAD XOR L
+    { Op::XOR, Opd::HL_IND, Opd::NONE, 1, { 8, 0 }, 0x00, 0x70, 0x80 }, // 0xAE XOR (HL)
+    { Op::XOR, Opd::A, Opd::NONE, 1, { 4, 0 }, 0x00, 0x70, 0x80 }, // 0xAF XOR A
+    { Op::OR, Opd::B, Opd::NONE, 1, { 4, 0 }, 0x00, 0x70, 0x80 }, // 0xB0 OR B
+    { Op::OR, Opd::C, Opd::NONE, 1, { 4, 0 }, 0x00, 0x70, 0x80 }, // 0xB1 OR C
+    { Op::OR, Opd::D, Opd::NONE, 1, { 4, 0 }, 0x00, 0x70, 0x80 }, // 0xB2 OR D
+    { Op::OR, Opd::E, Opd::NONE, 1, { 4, 0 }, 0x00, 0x70, 0x80 }, // 0xB3 OR E
+    { Op::OR, Opd::H, Opd::NONE, 1, { 4, 0 }, 0x00, 0x70, 0x80 }, // 0xB4 OR H
+    { Op::OR, Opd::L, Opd::NONE, 1, { 4, 0 }, 0x00, 0x70, 0x80 }, // 0xB5 OR L
+    { Op::OR, Opd::HL_IND, Opd::NONE, 1, { 8, 0 }, 0x00, 0x70, 0x80 }, // 0xB6 OR (HL)
+    { Op::OR, Opd::A, Opd::NONE, 1, { 4, 0 }, 0x00, 0x70, 0x80 }, // 0xB7 OR A
+    { Op::CP, Opd::B, Opd::NONE, 1, { 4, 0 }, 0x40, 0x00, 0xB0 }, // 0xB8 CP B
+    { Op::CP, Opd::C, Opd::NONE, 1, { 4, 0 }, 0x40, 0x00, 0xB0 }, // 0xB9 CP C
+    { Op::CP, Opd::D, Opd::NONE, 1, { 4, 0 }, 0x40, 0x00, 0xB0 }, // 0xBA CP D
+    { Op::CP, Opd::E, Opd::NONE, 1, { 4, 0 }, 0x40, 0x00, 0xB0 }, // 0xBB CP E
+    { Op::CP, Opd::H, Opd::NONE, 1, { 4, 0 }, 0x40, 0x00, 0xB0 }, // 0xBC CP H
+    { Op::CP, Opd::L, Opd::NONE, 1, { 4, 0 }, 0x40, 0x00, 0xB0 }, // 0xBD CP L
+    { Op::CP, Opd::HL_IND, Opd::NONE, 1, { 8, 0 }, 0x40, 0x00, 0xB0 }, // 0xBE CP (HL)
+    { Op::CP, Opd::A, Opd::NONE, 1, { 4, 0 }, 0x40, 0x00, 0xB0 }, // 0xBF CP A
+    { Op::RET, Opd::NZ, Opd::NONE, 1, { 20, 8 }, 0x00, 0x00, 0x00 }, // 0xC0 RET NZ
+    { Op::POP, Opd::BC, Opd::NONE, 1, { 12, 0 }, 0x00, 0x00, 0x00 }, // 0xC1 POP BC
+    { Op::JP, Opd::NZ, Opd::A16, 3, { 16, 12 }, 0x00, 0x00, 0x00 }, // 0xC2 JP NZ,a16
+    { Op::JP, Opd::A16, Opd::NONE, 3, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xC3 JP a16
+    { Op::CALL, Opd::NZ, Opd::A16, 3, { 24, 12 }, 0x00, 0x00, 0x00 }, // 0xC4 CALL NZ,a16
+    { Op::PUSH, Opd::BC, Opd::NONE, 1, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xC5 PUSH BC
+    { Op::ADD, Opd::A, Opd::D8, 2, { 8, 0 }, 0x00, 0x40, 0xB0 }, // 0xC6 ADD A,d8
+    { Op::RST, Opd::RST_00, Opd::NONE, 1, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xC7 RST 00H
+    { Op::RET, Opd::Z, Opd::NONE, 1, { 20, 8 }, 0x00, 0x00, 0x00 }, // 0xC8 RET Z
+    { Op::RET, Opd::NONE, Opd::NONE, 1, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xC9 RET
+    { Op::JP, Opd::Z, Opd::A16, 3, { 16, 12 }, 0x00, 0x00, 0x00 }, // 0xCA JP Z,a16
+    { Op::PREFIX, Opd::CB, Opd::NONE, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0xCB PREFIX CB
+    { Op::CALL, Opd::Z, Opd::A16, 3, { 24, 12 }, 0x00, 0x00, 0x00 }, // 0xCC CALL Z,a16
+    { Op::CALL, Opd::A16, Opd::NONE, 3, { 24, 0 }, 0x00, 0x00, 0x00 }, // 0xCD CALL a16
+    { Op::ADC, Opd::A, Opd::D8, 2, { 8, 0 }, 0x00, 0x40, 0xB0 }, // 0xCE ADC A,d8
+    { Op::RST, Opd::RST_08, Opd::NONE, 1, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xCF RST 08H
+    { Op::RET, Opd::NC, Opd::NONE, 1, { 20, 8 }, 0x00, 0x00, 0x00 }, // 0xD0 RET NC
+    { Op::POP, Opd::DE, Opd::NONE, 1, { 12, 0 }, 0x00, 0x00, 0x00 }, // 0xD1 POP DE
+    { Op::JP, Opd::NC, Opd::A16, 3, { 16, 12 }, 0x00, 0x00, 0x00 }, // 0xD2 JP NC,a16
+    { Op::INVALID, Opd::NONE, Opd::NONE, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0xD3 --
+    { Op::CALL, Opd::NC, Opd::A16, 3, { 24, 12 }, 0x00, 0x00, 0x00 }, // 0xD4 CALL NC,a16
+    { Op::PUSH, Opd::DE, Opd::NONE, 1, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xD5 PUSH DE
+    { Op::SUB, Opd::D8, Opd::NONE, 2, { 8, 0 }, 0x40, 0x00, 0xB0 }, // 0xD6 SUB d8
+    { Op::RST, Opd::RST_10, Opd::NONE, 1, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xD7 RST 10H
+    { Op::RET, Opd::C, Opd::NONE, 1, { 20, 8 }, 0x00, 0x00, 0x00 }, // 0xD8 RET C
+    { Op::RETI, Opd::NONE, Opd::NONE, 1, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xD9 RETI
+    { Op::JP, Opd::C, Opd::A16, 3, { 16, 12 }, 0x00, 0x00, 0x00 }, // 0xDA JP C,a16
+    { Op::INVALID, Opd::NONE, Opd::NONE, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0xDB --
+    { Op::CALL, Opd::C, Opd::A16, 3, { 24, 12 }, 0x00, 0x00, 0x00 }, // 0xDC CALL C,a16
+    { Op::INVALID, Opd::NONE, Opd::NONE, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0xDD --
+    { Op::SBC, Opd::A, Opd::D8, 2, { 8, 0 }, 0x40, 0x00, 0xB0 }, // 0xDE SBC A,d8
+    { Op::RST, Opd::RST_18, Opd::NONE, 1, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xDF RST 18H
+    { Op::LDH, Opd::A8_IND, Opd::A, 2, { 12, 0 }, 0x00, 0x00, 0x00 }, // 0xE0 LDH (a8),A
+    { Op::POP, Opd::HL, Opd::NONE, 1, { 12, 0 }, 0x00, 0x00, 0x00 }, // 0xE1 POP HL
+    { Op::LD, Opd::C_IND, Opd::A, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xE2 LD (C),A
+    { Op::INVALID, Opd::NONE, Opd::NONE, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0xE3 --
+    { Op::INVALID, Opd::NONE, Opd::NONE, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0xE4 --
+    { Op::PUSH, Opd::HL, Opd::NONE, 1, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xE5 PUSH HL
+    { Op::AND, Opd::D8, Opd::NONE, 2, { 8, 0 }, 0x20, 0x50, 0x80 }, // 0xE6 AND d8
+    { Op::RST, Opd::RST_20, Opd::NONE, 1, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xE7 RST 20H
+    { Op::ADD, Opd::SP, Opd::R8, 2, { 16, 0 }, 0x00, 0xC0, 0x30 }, // 0xE8 ADD SP,r8
+    { Op::JP, Opd::HL, Opd::NONE, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0xE9 JP HL
+    { Op::LD, Opd::A16_IND, Opd::A, 3, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xEA LD (a16),A
+    { Op::INVALID, Opd::NONE, Opd::NONE, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0xEB --
+    { Op::INVALID, Opd::NONE, Opd::NONE, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0xEC --
+    { Op::INVALID, Opd::NONE, Opd::NONE, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0xED --
+    { Op::XOR, Opd::D8, Opd::NONE, 2, { 8, 0 }, 0x00, 0x70, 0x80 }, // 0xEE XOR d8
+    { Op::RST, Opd::RST_28, Opd::NONE, 1, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xEF RST 28H
+    { Op::LDH, Opd::A, Opd::A8_IND, 2, { 12, 0 }, 0x00, 0x00, 0x00 }, // 0xF0 LDH A,(a8)
+    { Op::POP, Opd::AF, Opd::NONE, 1, { 12, 0 }, 0x00, 0x00, 0xF0 }, // 0xF1 POP AF
+    { Op::LD, Opd::A, Opd::C_IND, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xF2 LD A,(C)
+    { Op::DI, Opd::NONE, Opd::NONE, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0xF3 DI
+    { Op::INVALID, Opd::NONE, Opd::NONE, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0xF4 --
+    { Op::PUSH, Opd::AF, Opd::NONE, 1, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xF5 PUSH AF
+    { Op::OR, Opd::D8, Opd::NONE, 2, { 8, 0 }, 0x00, 0x70, 0x80 }, // 0xF6 OR d8
+    { Op::RST, Opd::RST_30, Opd::NONE, 1, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xF7 RST 30H
+    { Op::LD, Opd::HL, Opd::SP_R8, 2, { 12, 0 }, 0x00, 0xC0, 0x30 }, // 0xF8 LD HL,SP+r8
+    { Op::LD, Opd::SP, Opd::HL, 1, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xF9 LD SP,HL
+    { Op::LD, Opd::A, Opd::A16_IND, 3, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xFA LD A,(a16)
+    { Op::EI, Opd::NONE, Opd::NONE, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0xFB EI
+    { Op::INVALID, Opd::NONE, Opd::NONE, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0xFC --
+    { Op::INVALID, Opd::NONE, Opd::NONE, 1, { 4, 0 }, 0x00, 0x00, 0x00 }, // 0xFD --
+    { Op::CP, Opd::D8, Opd::NONE, 2, { 8, 0 }, 0x40, 0x00, 0xB0 }, // 0xFE CP d8
+    { Op::RST, Opd::RST_38, Opd::NONE, 1, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xFF RST 38H
+};
+
+constexpr OpcodeInfo cbprefixed_table[256] = {
+    { Op::RLC, Opd::B, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x00 RLC B
+    { Op::RLC, Opd::C, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x01 RLC C
+    { Op::RLC, Opd::D, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x02 RLC D
+    { Op::RLC, Opd::E, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x03 RLC E
+    { Op::RLC, Opd::H, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x04 RLC H
+    { Op::RLC, Opd::L, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x05 RLC L
+    { Op::RLC, Opd::HL_IND, Opd::NONE, 2, { 16, 0 }, 0x00, 0x60, 0x90 }, // 0x06 RLC (HL)
+    { Op::RLC, Opd::A, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x07 RLC A
+    { Op::RRC, Opd::B, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x08 RRC B
+    { Op::RRC, Opd::C, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x09 RRC C
+    { Op::RRC, Opd::D, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x0A RRC D
+    { Op::RRC, Opd::E, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x0B RRC E
+    { Op::RRC, Opd::H, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x0C RRC H
+    { Op::RRC, Opd::L, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x0D RRC L
+    { Op::RRC, Opd::HL_IND, Opd::NONE, 2, { 16, 0 }, 0x00, 0x60, 0x90 }, // 0x0E RRC (HL)
+    { Op::RRC, Opd::A, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x0F RRC A
+    { Op::RL, Opd::B, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x10 RL B
+    { Op::RL, Opd::C, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x11 RL C
+    { Op::RL, Opd::D, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x12 RL D
+    { Op::RL, Opd::E, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x13 RL E
+    { Op::RL, Opd::H, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x14 RL H
+    { Op::RL, Opd::L, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x15 RL L
+    { Op::RL, Opd::HL_IND, Opd::NONE, 2, { 16, 0 }, 0x00, 0x60, 0x90 }, // 0x16 RL (HL)
+    { Op::RL, Opd::A, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x17 RL A
+    { Op::RR, Opd::B, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x18 RR B
+    { Op::RR, Opd::C, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x19 RR C
+    { Op::RR, Opd::D, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x1A RR D
+    { Op::RR, Opd::E, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x1B RR E
+    { Op::RR, Opd::H, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x1C RR H
+    { Op::RR, Opd::L, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x1D RR L
+    { Op::RR, Opd::HL_IND, Opd::NONE, 2, { 16, 0 }, 0x00, 0x60, 0x90 }, // 0x1E RR (HL)
+    { Op::RR, Opd::A, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x1F RR A
+    { Op::SLA, Opd::B, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x20 SLA B
+    { Op::SLA, Opd::C, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x21 SLA C
+    { Op::SLA, Opd::D, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x22 SLA D
+    { Op::SLA, Opd::E, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x23 SLA E
+    { Op::SLA, Opd::H, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x24 SLA H
+    { Op::SLA, Opd::L, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x25 SLA L
+    { Op::SLA, Opd::HL_IND, Opd::NONE, 2, { 16, 0 }, 0x00, 0x60, 0x90 }, // 0x26 SLA (HL)
+    { Op::SLA, Opd::A, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x27 SLA A
+    { Op::SRA, Opd::B, Opd::NONE, 2, { 8, 0 }, 0x00, 0x70, 0x80 }, // 0x28 SRA B
+    { Op::SRA, Opd::C, Opd::NONE, 2, { 8, 0 }, 0x00, 0x70, 0x80 }, // 0x29 SRA C
+    { Op::SRA, Opd::D, Opd::NONE, 2, { 8, 0 }, 0x00, 0x70, 0x80 }, // 0x2A SRA D
+    { Op::SRA, Opd::E, Opd::NONE, 2, { 8, 0 }, 0x00, 0x70, 0x80 }, // 0x2B SRA E
+    { Op::SRA, Opd::H, Opd::NONE, 2, { 8, 0 }, 0x00, 0x70, 0x80 }, // 0x2C SRA H
+    { Op::SRA, Opd::L, Opd::NONE, 2, { 8, 0 }, 0x00, 0x70, 0x80 }, // 0x2D SRA L
+    { Op::SRA, Opd::HL_IND, Opd::NONE, 2, { 16, 0 }, 0x00, 0x70, 0x80 }, // 0x2E SRA (HL)
+    { Op::SRA, Opd::A, Opd::NONE, 2, { 8, 0 }, 0x00, 0x70, 0x80 }, // 0x2F SRA A
+    { Op::SWAP, Opd::B, Opd::NONE, 2, { 8, 0 }, 0x00, 0x70, 0x80 }, // 0x30 SWAP B
+    { Op::SWAP, Opd::C, Opd::NONE, 2, { 8, 0 }, 0x00, 0x70, 0x80 }, // 0x31 SWAP C
+    { Op::SWAP, Opd::D, Opd::NONE, 2, { 8, 0 }, 0x00, 0x70, 0x80 }, // 0x32 SWAP D
+    { Op::SWAP, Opd::E, Opd::NONE, 2, { 8, 0 }, 0x00, 0x70, 0x80 }, // 0x33 SWAP E
+    { Op::SWAP, Opd::H, Opd::NONE, 2, { 8, 0 }, 0x00, 0x70, 0x80 }, // 0x34 SWAP H
+    { Op::SWAP, Opd::L, Opd::NONE, 2, { 8, 0 }, 0x00, 0x70, 0x80 }, // 0x35 SWAP L
+    { Op::SWAP, Opd::HL_IND, Opd::NONE, 2, { 16, 0 }, 0x00, 0x70, 0x80 }, // 0x36 SWAP (HL)
+    { Op::SWAP, Opd::A, Opd::NONE, 2, { 8, 0 }, 0x00, 0x70, 0x80 }, // 0x37 SWAP A
+    { Op::SRL, Opd::B, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x38 SRL B
+    { Op::SRL, Opd::C, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x39 SRL C
+    { Op::SRL, Opd::D, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x3A SRL D
+    { Op::SRL, Opd::E, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x3B SRL E
+    { Op::SRL, Opd::H, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x3C SRL H
+    { Op::SRL, Opd::L, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x3D SRL L
+    { Op::SRL, Opd::HL_IND, Opd::NONE, 2, { 16, 0 }, 0x00, 0x60, 0x90 }, // 0x3E SRL (HL)
+    { Op::SRL, Opd::A, Opd::NONE, 2, { 8, 0 }, 0x00, 0x60, 0x90 }, // 0x3F SRL A
+    { Op::BIT, Opd::N0, Opd::B, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x40 BIT 0,B
+    { Op::BIT, Opd::N0, Opd::C, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x41 BIT 0,C
+    { Op::BIT, Opd::N0, Opd::D, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x42 BIT 0,D
+    { Op::BIT, Opd::N0, Opd::E, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x43 BIT 0,E
+    { Op::BIT, Opd::N0, Opd::H, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x44 BIT 0,H
+    { Op::BIT, Opd::N0, Opd::L, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x45 BIT 0,L
+    { Op::BIT, Opd::N0, Opd::HL_IND, 2, { 16, 0 }, 0x20, 0x40, 0x80 }, // 0x46 BIT 0,(HL)
+    { Op::BIT, Opd::N0, Opd::A, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x47 BIT 0,A
+    { Op::BIT, Opd::N1, Opd::B, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x48 BIT 1,B
+    { Op::BIT, Opd::N1, Opd::C, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x49 BIT 1,C
+    { Op::BIT, Opd::N1, Opd::D, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x4A BIT 1,D
+    { Op::BIT, Opd::N1, Opd::E, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x4B BIT 1,E
+    { Op::BIT, Opd::N1, Opd::H, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x4C BIT 1,H
+    { Op::BIT, Opd::N1, Opd::L, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x4D BIT 1,L
+    { Op::BIT, Opd::N1, Opd::HL_IND, 2, { 16, 0 }, 0x20, 0x40, 0x80 }, // 0x4E BIT 1,(HL)
+    { Op::BIT, Opd::N1, Opd::A, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x4F BIT 1,A
+    { Op::BIT, Opd::N2, Opd::B, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x50 BIT 2,B
+    { Op::BIT, Opd::N2, Opd::C, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x51 BIT 2,C
+    { Op::BIT, Opd::N2, Opd::D, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x52 BIT 2,D
+    { Op::BIT, Opd::N2, Opd::E, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x53 BIT 2,E
+    { Op::BIT, Opd::N2, Opd::H, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x54 BIT 2,H
+    { Op::BIT, Opd::N2, Opd::L, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x55 BIT 2,L
+    { Op::BIT, Opd::N2, Opd::HL_IND, 2, { 16, 0 }, 0x20, 0x40, 0x80 }, // 0x56 BIT 2,(HL)
+    { Op::BIT, Opd::N2, Opd::A, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x57 BIT 2,A
+    { Op::BIT, Opd::N3, Opd::B, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x58 BIT 3,B
+    { Op::BIT, Opd::N3, Opd::C, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x59 BIT 3,C
+    { Op::BIT, Opd::N3, Opd::D, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x5A BIT 3,D
+    { Op::BIT, Opd::N3, Opd::E, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x5B BIT 3,E
+    { Op::BIT, Opd::N3, Opd::H, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x5C BIT 3,H
+    { Op::BIT, Opd::N3, Opd::L, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x5D BIT 3,L
+    { Op::BIT, Opd::N3, Opd::HL_IND, 2, { 16, 0 }, 0x20, 0x40, 0x80 }, // 0x5E BIT 3,(HL)
+    { Op::BIT, Opd::N3, Opd::A, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x5F BIT 3,A
+    { Op::BIT, Opd::N4, Opd::B, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x60 BIT 4,B
+    { Op::BIT, Opd::N4, Opd::C, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x61 BIT 4,C
+    { Op::BIT, Opd::N4, Opd::D, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x62 BIT 4,D
+    { Op::BIT, Opd::N4, Opd::E, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x63 BIT 4,E
+    { Op::BIT, Opd::N4, Opd::H, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x64 BIT 4,H
+    { Op::BIT, Opd::N4, Opd::L, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x65 BIT 4,L
+    { Op::BIT, Opd::N4, Opd::HL_IND, 2, { 16, 0 }, 0x20, 0x40, 0x80 }, // 0x66 BIT 4,(HL)
+    { Op::BIT, Opd::N4, Opd::A, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x67 BIT 4,A
+    { Op::BIT, Opd::N5, Opd::B, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x68 BIT 5,B
+    { Op::BIT, Opd::N5, Opd::C, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x69 BIT 5,C
+    { Op::BIT, Opd::N5, Opd::D, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x6A BIT 5,D
+    { Op::BIT, Opd::N5, Opd::E, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x6B BIT 5,E
+    { Op::BIT, Opd::N5, Opd::H, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x6C BIT 5,H
+    { Op::BIT, Opd::N5, Opd::L, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x6D BIT 5,L
+    { Op::BIT, Opd::N5, Opd::HL_IND, 2, { 16, 0 }, 0x20, 0x40, 0x80 }, // 0x6E BIT 5,(HL)
+    { Op::BIT, Opd::N5, Opd::A, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x6F BIT 5,A
+    { Op::BIT, Opd::N6, Opd::B, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x70 BIT 6,B
+    { Op::BIT, Opd::N6, Opd::C, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x71 BIT 6,C
+    { Op::BIT, Opd::N6, Opd::D, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x72 BIT 6,D
+    { Op::BIT, Opd::N6, Opd::E, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x73 BIT 6,E
+    { Op::BIT, Opd::N6, Opd::H, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x74 BIT 6,H
+    { Op::BIT, Opd::N6, Opd::L, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x75 BIT 6,L
+    { Op::BIT, Opd::N6, Opd::HL_IND, 2, { 16, 0 }, 0x20, 0x40, 0x80 }, // 0x76 BIT 6,(HL)
+    { Op::BIT, Opd::N6, Opd::A, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x77 BIT 6,A
+    { Op::BIT, Opd::N7, Opd::B, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x78 BIT 7,B
+    { Op::BIT, Opd::N7, Opd::C, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x79 BIT 7,C
+    { Op::BIT, Opd::N7, Opd::D, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x7A BIT 7,D
+    { Op::BIT, Opd::N7, Opd::E, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x7B BIT 7,E
+    { Op::BIT, Opd::N7, Opd::H, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x7C BIT 7,H
+    { Op::BIT, Opd::N7, Opd::L, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x7D BIT 7,L
+    { Op::BIT, Opd::N7, Opd::HL_IND, 2, { 16, 0 }, 0x20, 0x40, 0x80 }, // 0x7E BIT 7,(HL)
+    { Op::BIT, Opd::N7, Opd::A, 2, { 8, 0 }, 0x20, 0x40, 0x80 }, // 0x7F BIT 7,A
+    { Op::RES, Opd::N0, Opd::B, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x80 RES 0,B
+    { Op::RES, Opd::N0, Opd::C, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x81 RES 0,C
+    { Op::RES, Opd::N0, Opd::D, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x82 RES 0,D
+    { Op::RES, Opd::N0, Opd::E, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x83 RES 0,E
+    { Op::RES, Opd::N0, Opd::H, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x84 RES 0,H
+    { Op::RES, Opd::N0, Opd::L, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x85 RES 0,L
+    { Op::RES, Opd::N0, Opd::HL_IND, 2, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0x86 RES 0,(HL)
+    { Op::RES, Opd::N0, Opd::A, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x87 RES 0,A
+    { Op::RES, Opd::N1, Opd::B, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x88 RES 1,B
+    { Op::RES, Opd::N1, Opd::C, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x89 RES 1,C
+    { Op::RES, Opd::N1, Opd::D, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x8A RES 1,D
+    { Op::RES, Opd::N1, Opd::E, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x8B RES 1,E
+    { Op::RES, Opd::N1, Opd::H, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x8C RES 1,H
+    { Op::RES, Opd::N1, Opd::L, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x8D RES 1,L
+    { Op::RES, Opd::N1, Opd::HL_IND, 2, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0x8E RES 1,(HL)
+    { Op::RES, Opd::N1, Opd::A, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x8F RES 1,A
+    { Op::RES, Opd::N2, Opd::B, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x90 RES 2,B
+    { Op::RES, Opd::N2, Opd::C, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x91 RES 2,C
+    { Op::RES, Opd::N2, Opd::D, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x92 RES 2,D
+    { Op::RES, Opd::N2, Opd::E, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x93 RES 2,E
+    { Op::RES, Opd::N2, Opd::H, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x94 RES 2,H
+    { Op::RES, Opd::N2, Opd::L, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x95 RES 2,L
+    { Op::RES, Opd::N2, Opd::HL_IND, 2, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0x96 RES 2,(HL)
+    { Op::RES, Opd::N2, Opd::A, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x97 RES 2,A
+    { Op::RES, Opd::N3, Opd::B, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x98 RES 3,B
+    { Op::RES, Opd::N3, Opd::C, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x99 RES 3,C
+    { Op::RES, Opd::N3, Opd::D, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x9A RES 3,D
+    { Op::RES, Opd::N3, Opd::E, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x9B RES 3,E
+    { Op::RES, Opd::N3, Opd::H, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x9C RES 3,H
+    { Op::RES, Opd::N3, Opd::L, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x9D RES 3,L
+    { Op::RES, Opd::N3, Opd::HL_IND, 2, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0x9E RES 3,(HL)
+    { Op::RES, Opd::N3, Opd::A, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0x9F RES 3,A
+    { Op::RES, Opd::N4, Opd::B, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xA0 RES 4,B
+    { Op::RES, Opd::N4, Opd::C, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xA1 RES 4,C
+    { Op::RES, Opd::N4, Opd::D, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xA2 RES 4,D
+    { Op::RES, Opd::N4, Opd::E, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xA3 RES 4,E
+    { Op::RES, Opd::N4, Opd::H, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xA4 RES 4,H
+    { Op::RES, Opd::N4, Opd::L, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xA5 RES 4,L
+    { Op::RES, Opd::N4, Opd::HL_IND, 2, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xA6 RES 4,(HL)
+    { Op::RES, Opd::N4, Opd::A, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xA7 RES 4,A
+    { Op::RES, Opd::N5, Opd::B, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xA8 RES 5,B
+    { Op::RES, Opd::N5, Opd::C, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xA9 RES 5,C
+    { Op::RES, Opd::N5, Opd::D, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xAA RES 5,D
+    { Op::RES, Opd::N5, Opd::E, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xAB RES 5,E
+    { Op::RES, Opd::N5, Opd::H, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xAC RES 5,H
+    { Op::RES, Opd::N5, Opd::L, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xAD RES 5,L
+    { Op::RES, Opd::N5, Opd::HL_IND, 2, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xAE RES 5,(HL)
+    { Op::RES, Opd::N5, Opd::A, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xAF RES 5,A
+    { Op::RES, Opd::N6, Opd::B, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xB0 RES 6,B
+    { Op::RES, Opd::N6, Opd::C, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xB1 RES 6,C
+    { Op::RES, Opd::N6, Opd::D, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xB2 RES 6,D
+    { Op::RES, Opd::N6, Opd::E, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xB3 RES 6,E
+    { Op::RES, Opd::N6, Opd::H, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xB4 RES 6,H
+    { Op::RES, Opd::N6, Opd::L, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xB5 RES 6,L
+    { Op::RES, Opd::N6, Opd::HL_IND, 2, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xB6 RES 6,(HL)
+    { Op::RES, Opd::N6, Opd::A, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xB7 RES 6,A
+    { Op::RES, Opd::N7, Opd::B, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xB8 RES 7,B
+    { Op::RES, Opd::N7, Opd::C, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xB9 RES 7,C
+    { Op::RES, Opd::N7, Opd::D, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xBA RES 7,D
+    { Op::RES, Opd::N7, Opd::E, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xBB RES 7,E
+    { Op::RES, Opd::N7, Opd::H, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xBC RES 7,H
+    { Op::RES, Opd::N7, Opd::L, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xBD RES 7,L
+    { Op::RES, Opd::N7, Opd::HL_IND, 2, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xBE RES 7,(HL)
+    { Op::RES, Opd::N7, Opd::A, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xBF RES 7,A
+    { Op::SET, Opd::N0, Opd::B, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xC0 SET 0,B
+    { Op::SET, Opd::N0, Opd::C, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xC1 SET 0,C
+    { Op::SET, Opd::N0, Opd::D, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xC2 SET 0,D
+    { Op::SET, Opd::N0, Opd::E, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xC3 SET 0,E
+    { Op::SET, Opd::N0, Opd::H, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xC4 SET 0,H
+    { Op::SET, Opd::N0, Opd::L, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xC5 SET 0,L
+    { Op::SET, Opd::N0, Opd::HL_IND, 2, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xC6 SET 0,(HL)
+    { Op::SET, Opd::N0, Opd::A, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xC7 SET 0,A
+    { Op::SET, Opd::N1, Opd::B, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xC8 SET 1,B
+    { Op::SET, Opd::N1, Opd::C, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xC9 SET 1,C
+    { Op::SET, Opd::N1, Opd::D, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xCA SET 1,D
+    { Op::SET, Opd::N1, Opd::E, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xCB SET 1,E
+    { Op::SET, Opd::N1, Opd::H, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xCC SET 1,H
+    { Op::SET, Opd::N1, Opd::L, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xCD SET 1,L
+    { Op::SET, Opd::N1, Opd::HL_IND, 2, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xCE SET 1,(HL)
+    { Op::SET, Opd::N1, Opd::A, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xCF SET 1,A
+    { Op::SET, Opd::N2, Opd::B, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xD0 SET 2,B
+    { Op::SET, Opd::N2, Opd::C, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xD1 SET 2,C
+    { Op::SET, Opd::N2, Opd::D, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xD2 SET 2,D
+    { Op::SET, Opd::N2, Opd::E, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xD3 SET 2,E
+    { Op::SET, Opd::N2, Opd::H, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xD4 SET 2,H
+    { Op::SET, Opd::N2, Opd::L, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xD5 SET 2,L
+    { Op::SET, Opd::N2, Opd::HL_IND, 2, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xD6 SET 2,(HL)
+    { Op::SET, Opd::N2, Opd::A, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xD7 SET 2,A
+    { Op::SET, Opd::N3, Opd::B, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xD8 SET 3,B
+    { Op::SET, Opd::N3, Opd::C, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xD9 SET 3,C
+    { Op::SET, Opd::N3, Opd::D, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xDA SET 3,D
+    { Op::SET, Opd::N3, Opd::E, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xDB SET 3,E
+    { Op::SET, Opd::N3, Opd::H, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xDC SET 3,H
+    { Op::SET, Opd::N3, Opd::L, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xDD SET 3,L
+    { Op::SET, Opd::N3, Opd::HL_IND, 2, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xDE SET 3,(HL)
+    { Op::SET, Opd::N3, Opd::A, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xDF SET 3,A
+    { Op::SET, Opd::N4, Opd::B, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xE0 SET 4,B
+    { Op::SET, Opd::N4, Opd::C, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xE1 SET 4,C
+    { Op::SET, Opd::N4, Opd::D, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xE2 SET 4,D
+    { Op::SET, Opd::N4, Opd::E, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xE3 SET 4,E
+    { Op::SET, Opd::N4, Opd::H, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xE4 SET 4,H
+    { Op::SET, Opd::N4, Opd::L, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xE5 SET 4,L
+    { Op::SET, Opd::N4, Opd::HL_IND, 2, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xE6 SET 4,(HL)
+    { Op::SET, Opd::N4, Opd::A, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xE7 SET 4,A
+    { Op::SET, Opd::N5, Opd::B, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xE8 SET 5,B
+    { Op::SET, Opd::N5, Opd::C, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xE9 SET 5,C
+    { Op::SET, Opd::N5, Opd::D, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xEA SET 5,D
+    { Op::SET, Opd::N5, Opd::E, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xEB SET 5,E
+    { Op::SET, Opd::N5, Opd::H, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xEC SET 5,H
+    { Op::SET, Opd::N5, Opd::L, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xED SET 5,L
+    { Op::SET, Opd::N5, Opd::HL_IND, 2, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xEE SET 5,(HL)
+    { Op::SET, Opd::N5, Opd::A, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xEF SET 5,A
+    { Op::SET, Opd::N6, Opd::B, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xF0 SET 6,B
+    { Op::SET, Opd::N6, Opd::C, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xF1 SET 6,C
+    { Op::SET, Opd::N6, Opd::D, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xF2 SET 6,D
+    { Op::SET, Opd::N6, Opd::E, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xF3 SET 6,E
+    { Op::SET, Opd::N6, Opd::H, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xF4 SET 6,H
+    { Op::SET, Opd::N6, Opd::L, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xF5 SET 6,L
+    { Op::SET, Opd::N6, Opd::HL_IND, 2, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xF6 SET 6,(HL)
+    { Op::SET, Opd::N6, Opd::A, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xF7 SET 6,A
+    { Op::SET, Opd::N7, Opd::B, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xF8 SET 7,B
+    { Op::SET, Opd::N7, Opd::C, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xF9 SET 7,C
+    { Op::SET, Opd::N7, Opd::D, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xFA SET 7,D
+    { Op::SET, Opd::N7, Opd::E, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xFB SET 7,E
+    { Op::SET, Opd::N7, Opd::H, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xFC SET 7,H
+    { Op::SET, Opd::N7, Opd::L, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xFD SET 7,L
+    { Op::SET, Opd::N7, Opd::HL_IND, 2, { 16, 0 }, 0x00, 0x00, 0x00 }, // 0xFE SET 7,(HL)
+    { Op::SET, Opd::N7, Opd::A, 2, { 8, 0 }, 0x00, 0x00, 0x00 }, // 0xFF SET 7,A
+};
@@ -0,0 +1,134 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#if (defined(__x86_64__) || defined(_M_X64)) && !defined(GB_NO_SIMD)
+#define GB_SIMD_X64
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define GB_TARGET_AVX2
+#else
+#define GB_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+// Kernels that turn a line of a map layer into screen pixels.
+//
+// A kernel reads `count` (at most 160) color numbers from a 256-pixel line
+// of MapCache, starting `start` pixels in and wrapping around, and writes
+// the XRGB8888 pixels `palette` gives for them (BGP, see PPU::palette).
+// The vector kernels look up 16 (SSE2) or 32 (AVX2) pixels per iteration,
+// by selects or a lane permute, and finish a run with a vector store
+// overlapping the one before rather than a pixel loop.
+//
+// The best kernel the host supports is picked at startup. GB_NO_SIMD builds
+// without the vector ones (non-x86-64 hosts always do). GB_SIMD_VERIFY
+// draws every line straight from VRAM as well, checks the map layers and
+// each kernel the host supports against that, and aborts on the first
+// pixel that differs.
+
+typedef void (*LayerKernel)(const uint8_t* line, uint8_t start, int count, const uint32_t* palette, uint32_t* out);
+
+struct LayerRenderer {
+    const char* name;
+    LayerKernel draw;
+};
+
+inline void draw_layer_scalar(const uint8_t* line, uint8_t start, int count, const uint32_t* palette, uint32_t* out) {
+    for (int x = 0; x < count; x++) out[x] = palette[line[(start + x) & 0xFF]];
+}
+
+#ifdef GB_SIMD_X64
+namespace layer_simd {
+
+// Each kernel splits the pixels into runs where the line wraps. A run
+// shorter than one iteration is left to the scalar kernel.
+
+inline void draw_sse2(const uint8_t* line, uint8_t start, int count, const uint32_t* palette, uint32_t* out) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi32(1), two = _mm_set1_epi32(2);
+    const __m128i c0 = _mm_set1_epi32((int)palette[0]), c1 = _mm_set1_epi32((int)palette[1]);
+    const __m128i c2 = _mm_set1_epi32((int)palette[2]), c3 = _mm_set1_epi32((int)palette[3]);
+    const __m128i c01 = _mm_xor_si128(c0, c1), c23 = _mm_xor_si128(c2, c3);
+    for (int x = 0; x < count; ) {
+        int from = (start + x) & 0xFF;
+        int run = std::min(count - x, 256 - from);
+        if (run < 16) {
+            draw_layer_scalar(line, (uint8_t)from, run, palette, out + x);
+            x += run;
+            continue;
+        }
+        for (int i = 0; i < run; i += 16) {
+            if (i + 16 > run) i = run - 16;     // last vector overlaps the one before
+            __m128i bytes = _mm_loadu_si128((const __m128i*)(line + from + i));
+            __m128i words[2] = { _mm_unpacklo_epi8(bytes, zero), _mm_unpackhi_epi8(bytes, zero) };
+            for (int q = 0; q < 4; q++) {
+                __m128i color = q & 1 ? _mm_unpackhi_epi16(words[q >> 1], zero) : _mm_unpacklo_epi16(words[q >> 1], zero);
+                __m128i bit0 = _mm_cmpeq_epi32(_mm_and_si128(color, one), one);
+                __m128i bit1 = _mm_cmpeq_epi32(_mm_and_si128(color, two), two);
+                __m128i low = _mm_xor_si128(c0, _mm_and_si128(bit0, c01));     // color 0 or 1
+                __m128i high = _mm_xor_si128(c2, _mm_and_si128(bit0, c23));    // color 2 or 3
+                __m128i pixel = _mm_xor_si128(low, _mm_and_si128(bit1, _mm_xor_si128(low, high)));
+                _mm_storeu_si128((__m128i*)(out + x + i + q * 4), pixel);
+            }
+        }
+        x += run;
+    }
+}
+
+GB_TARGET_AVX2 inline void draw_avx2(const uint8_t* line, uint8_t start, int count, const uint32_t* palette, uint32_t* out) {
+    const __m256i colors = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)palette));
+    for (int x = 0; x < count; ) {
+        int from = (start + x) & 0xFF;
+        int run = std::min(count - x, 256 - from);
+        if (run < 32) {
+            draw_layer_scalar(line, (uint8_t)from, run, palette, out + x);
+            x += run;
+            continue;
+        }
+        for (int i = 0; i < run; i += 32) {
+            if (i + 32 > run) i = run - 32;
+            for (int q = 0; q < 32; q += 8) {
+                __m256i color = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(line + from + i + q)));
+                _mm256_storeu_si256((__m256i*)(out + x + i + q), _mm256_permutevar8x32_epi32(colors, color));
+            }
+        }
+        x += run;
+    }
+}
+
+inline bool has_avx2() {
+#ifdef _MSC_VER
+    int regs[4];
+    __cpuid(regs, 1);
+    bool avx = (regs[2] & (1 << 27)) && (regs[2] & (1 << 28));     // OSXSAVE, AVX
+    if (!avx || (_xgetbv(0) & 6) != 6) return false;                // OS saves YMM
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+}   // namespace layer_simd
+#endif
+
+// Every kernel this host can run, best first; the scalar one is always last
+inline int layer_renderers(LayerRenderer* out) {
+    int n = 0;
+#ifdef GB_SIMD_X64
+    if (layer_simd::has_avx2()) out[n++] = { "AVX2", layer_simd::draw_avx2 };
+    out[n++] = { "SSE2", layer_simd::draw_sse2 };
+#endif
+    out[n++] = { "scalar", draw_layer_scalar };
+    return n;
+}
+
+// The kernel the PPU draws with
+inline const LayerRenderer* best_layer_renderer() {
+    static LayerRenderer renderers[3];
+    static int count = layer_renderers(renderers);
+    (void)count;
+    return &renderers[0];
+}
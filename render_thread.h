@@ -0,0 +1,140 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "line_renderer.h"
+#include "memory.h"
+#include "vram_index.h"
+
+// Draws the PPU's lines on a thread of its own.
+//
+// The emulation thread only records each line's LineState, and Memory
+// appends every CPU write to VRAM to a log instead of marking the caches.
+// The lines and writes of a frame make a batch. At VBlank the PPU hands
+// the batch over and goes on with the next frame while this thread replays
+// the writes into its own copy of VRAM, each line after the writes that came
+// before it, and draws the lines through its own tile cache and map layers.
+// So every line sees the registers, OAM entries and VRAM it would have been
+// drawn from on the emulation thread, raster effects included, and the
+// pixels are the same. Two batches alternate: one being recorded, one
+// being drawn.
+class RenderThread {
+public:
+    struct Batch {
+        std::vector<LineState> lines;
+        std::vector<VramWrite> vram_writes;
+        uint32_t* target = nullptr;     // where the lines go, as PPU::target
+        int pitch = 0;
+        bool frame_done = false;        // ends at VBlank rather than at the LCD going off
+    };
+
+    // Starts from a copy of the VRAM as it is now
+    explicit RenderThread(Memory& memory) : memory(memory) {
+        memcpy(vram_bytes, &memory.data[0x8000], sizeof(vram_bytes));
+        vram.reindex();
+        memory.vram_log = &recording->vram_writes;
+        thread = std::thread(&RenderThread::run, this);
+    }
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    // Stops after the batch being drawn; Memory's own VRAM index is rebuilt
+    // since it missed the writes logged meanwhile
+    ~RenderThread() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        thread.join();
+        memory.vram_log = nullptr;
+        memory.vram.reindex();
+    }
+
+    // A line finished on the emulation thread
+    void record(const LineState& line) {
+        recording->lines.push_back(line);
+        recording->lines.back().vram_writes = (uint32_t)recording->vram_writes.size();
+    }
+
+    // Waits until the batch handed over last has been drawn and returns it
+    // (null if there is none); it stays valid until the next submit
+    const Batch* wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return !submitted; });
+        const Batch* drawn = last_drawn;
+        last_drawn = nullptr;
+        return drawn;
+    }
+
+    // Hands over what has been recorded, drawn into `target`, and starts
+    // recording the next batch. Call wait() first.
+    void submit(uint32_t* target, int pitch, bool frame_done) {
+        Batch* batch = recording;
+        batch->target = target;
+        batch->pitch = pitch;
+        batch->frame_done = frame_done;
+        recording = batch == &batches[0] ? &batches[1] : &batches[0];
+        recording->lines.clear();
+        recording->vram_writes.clear();
+        memory.vram_log = &recording->vram_writes;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            submitted = batch;
+        }
+        wake.notify_one();
+    }
+
+    // The renderer's counters as of the last batch drawn
+    RenderStats stats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return drawn_stats;
+    }
+
+    const char* layer_renderer_name() const { return renderer.layer_renderer->name; }
+
+private:
+    Memory& memory;
+    uint8_t vram_bytes[0x2000] = {};
+    VramIndex vram{ vram_bytes };
+    LineRenderer renderer{ vram };
+    Batch batches[2];
+    Batch* recording = &batches[0];     // emulation thread only
+
+    std::mutex mutex;
+    std::condition_variable wake;       // a batch was submitted, or stop
+    std::condition_variable done;       // the submitted batch has been drawn
+    Batch* submitted = nullptr;
+    const Batch* last_drawn = nullptr;
+    RenderStats drawn_stats;
+    bool stopping = false;
+    std::thread thread;
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            wake.wait(lock, [this] { return submitted || stopping; });
+            if (!submitted) return;
+            Batch* batch = submitted;
+            lock.unlock();
+            draw(*batch);
+            lock.lock();
+            submitted = nullptr;
+            last_drawn = batch;
+            drawn_stats = renderer.stats();
+            done.notify_one();
+        }
+    }
+
+    void draw(const Batch& batch) {
+        size_t replayed = 0;
+        for (const LineState& line : batch.lines) {
+            for (; replayed < line.vram_writes; replayed++) vram.write(batch.vram_writes[replayed].addr, batch.vram_writes[replayed].value);
+            renderer.draw(line, batch.target + line.ly * batch.pitch);
+        }
+        for (; replayed < batch.vram_writes.size(); replayed++) vram.write(batch.vram_writes[replayed].addr, batch.vram_writes[replayed].value);
+    }
+};
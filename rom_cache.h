@@ -0,0 +1,170 @@
+#pragma once
+#include <stdio.h>
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Read-only cartridge ROM images.
+//
+// A ROM file is mapped straight into memory (mmap / MapViewOfFile, read
+// only) and the cartridge's ROM pages point into the mapping, so loading
+// reads nothing up front and the pages come from the OS file cache. Images
+// are never written; patching a ROM (test setup) copies the bank first, see
+// Cartridge::patch_bank.
+//
+// Files that are not a whole power-of-two number of 16 KB banks (at least
+// two) cannot be mapped as is, because the bank controller masks bank
+// numbers with the bank count. Those are read into a heap copy padded with
+// FF instead.
+class RomImage {
+public:
+    RomImage(const RomImage&) = delete;
+    RomImage& operator=(const RomImage&) = delete;
+
+    ~RomImage() {
+        if (!mapped) return;
+#ifdef _WIN32
+        UnmapViewOfFile(mapped);
+        CloseHandle(mapping);
+#else
+        munmap((void*)mapped, length);
+#endif
+    }
+
+    const uint8_t* data() const { return mapped ? mapped : heap.data(); }
+    size_t size() const { return length; }
+    bool is_mapped() const { return mapped != nullptr; }
+
+    // Maps the file, or reads it when it cannot be mapped. Null (with a
+    // message) when the file cannot be opened or is empty.
+    static std::shared_ptr<const RomImage> open(const std::string& path) {
+        std::shared_ptr<RomImage> image(new RomImage());
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            printf("Failed to open ROM file: %s\n", path.c_str());
+            return nullptr;
+        }
+        LARGE_INTEGER file_size;
+        GetFileSizeEx(file, &file_size);
+        size_t size = (size_t)file_size.QuadPart;
+        if (size > 0 && is_bank_aligned(size)) {
+            image->mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (image->mapping)
+                image->mapped = (const uint8_t*)MapViewOfFile(image->mapping, FILE_MAP_READ, 0, 0, 0);
+            if (!image->mapped && image->mapping) CloseHandle(image->mapping);
+        }
+        if (!image->mapped && size > 0) {
+            image->heap.resize(size);
+            DWORD got = 0;
+            ReadFile(file, image->heap.data(), (DWORD)size, &got, nullptr);
+            size = got;
+        }
+        CloseHandle(file);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            printf("Failed to open ROM file: %s\n", path.c_str());
+            return nullptr;
+        }
+        struct stat st;
+        size_t size = fstat(fd, &st) == 0 ? (size_t)st.st_size : 0;
+        if (size > 0 && is_bank_aligned(size)) {
+            void* mem = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+            if (mem != MAP_FAILED) image->mapped = (const uint8_t*)mem;
+        }
+        if (!image->mapped && size > 0) {
+            image->heap.resize(size);
+            ssize_t got = pread(fd, image->heap.data(), size, 0);
+            size = got > 0 ? (size_t)got : 0;
+        }
+        close(fd);
+#endif
+        if (size == 0) {
+            printf("ROM is empty: %s\n", path.c_str());
+            return nullptr;
+        }
+        image->length = size;
+        if (!image->mapped) image->pad();
+        return image;
+    }
+
+    // A heap image holding `bytes`, padded to whole banks
+    static std::shared_ptr<const RomImage> from_bytes(std::vector<uint8_t> bytes) {
+        std::shared_ptr<RomImage> image(new RomImage());
+        image->length = bytes.size();
+        image->heap = std::move(bytes);
+        image->pad();
+        return image;
+    }
+
+    // 32 KB of zeros, shared by every cartridge that has not loaded a ROM
+    static std::shared_ptr<const RomImage> blank() {
+        static std::shared_ptr<const RomImage> image = from_bytes(std::vector<uint8_t>(0x8000));
+        return image;
+    }
+
+private:
+    const uint8_t* mapped = nullptr;
+    size_t length = 0;
+    std::vector<uint8_t> heap;
+#ifdef _WIN32
+    HANDLE mapping = nullptr;
+#endif
+
+    RomImage() {}
+
+    static bool is_bank_aligned(size_t size) {
+        return size >= 0x8000 && size % 0x4000 == 0 && (size & (size - 1)) == 0;
+    }
+
+    void pad() {
+        size_t padded = 0x8000;
+        while (padded < length) padded *= 2;
+        heap.resize(padded, 0xFF);
+        length = padded;
+    }
+};
+
+// Hands out one shared image per ROM file. Every instance running the same
+// game points at the same mapping, so the ROM is resident once per process
+// however many sessions use it. An image is released when the last
+// cartridge using it goes away. Safe to use from several threads.
+class RomCache {
+public:
+    static RomCache& shared() {
+        static RomCache cache;
+        return cache;
+    }
+
+    std::shared_ptr<const RomImage> open(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::shared_ptr<const RomImage> image = images[path].lock();
+        if (image) {
+            hits++;
+            return image;
+        }
+        image = RomImage::open(path);
+        if (image) images[path] = image;
+        else images.erase(path);
+        return image;
+    }
+
+    uint64_t hits = 0;      // opens served from an image already loaded
+
+private:
+    std::mutex mutex;
+    std::map<std::string, std::weak_ptr<const RomImage>> images;
+};
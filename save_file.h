@@ -0,0 +1,223 @@
+#pragma once
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Battery-backed cartridge RAM kept in a memory-mapped .sav file.
+//
+// The cartridge's RAM pages point straight into a shared, writable mapping
+// of the file, so a guest write is an ordinary store and nothing is ever
+// copied out. Memory reports the first write of each frame with mark_dirty
+// (one atomic store); SaveSyncer's thread then flushes the mapping to disk
+// (msync / FlushViewOfFile) at the file's sync interval. The emulation
+// thread never waits on the disk. Closing the file flushes it one last time.
+//
+// The mapping is the OS page cache, so a crash of the emulator itself loses
+// nothing; a crash of the whole machine loses at most one sync interval.
+//
+// A save file is open for one cartridge at a time (an exclusive lock on
+// POSIX, the share mode on Windows), so two instances running the same game
+// never alias each other's RAM: the second one gets no save file and keeps
+// its RAM in memory.
+class SaveFile {
+public:
+    SaveFile(const SaveFile&) = delete;
+    SaveFile& operator=(const SaveFile&) = delete;
+    ~SaveFile();
+
+    uint8_t* data() const { return mapped; }
+    size_t size() const { return length; }
+    const std::string& path() const { return file_path; }
+
+    void mark_dirty() { dirty.store(true, std::memory_order_release); }
+
+    std::atomic<uint64_t> syncs{ 0 };     // flushes that found the file dirty
+
+    // Maps the first `size` bytes of the file, creating it (zero filled) or
+    // growing it as needed. Longer files keep their tail (RTC data some
+    // emulators append). Null, with a message, when that fails or another
+    // cartridge has the file open.
+    static std::unique_ptr<SaveFile> open(const std::string& path, size_t size,
+                                          std::chrono::milliseconds interval);
+
+private:
+    friend class SaveSyncer;
+
+    uint8_t* mapped = nullptr;
+    size_t length = 0;
+    std::string file_path;
+    std::chrono::milliseconds interval{ 1000 };
+    std::chrono::steady_clock::time_point next_sync;
+    std::atomic<bool> dirty{ false };
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+
+    SaveFile() {}
+
+    // Writes the mapping back if anything was written since the last flush
+    void sync() {
+        if (!dirty.exchange(false, std::memory_order_acquire)) return;
+#ifdef _WIN32
+        FlushViewOfFile(mapped, length);
+        FlushFileBuffers(file);
+#else
+        msync(mapped, length, MS_SYNC);
+#endif
+        syncs++;
+    }
+};
+
+// One background thread flushing every open save file at its own interval,
+// shared by all instances in the process. Started by the first file.
+class SaveSyncer {
+public:
+    static SaveSyncer& shared() {
+        static SaveSyncer syncer;
+        return syncer;
+    }
+
+    void add(SaveFile* save) {
+        std::lock_guard<std::mutex> lock(mutex);
+        save->next_sync = std::chrono::steady_clock::now() + save->interval;
+        saves.push_back(save);
+        if (!thread.joinable()) thread = std::thread(&SaveSyncer::run, this);
+        wake.notify_one();
+    }
+
+    // Once this returns the thread no longer touches `save`
+    void remove(SaveFile* save) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < saves.size(); i++) {
+            if (saves[i] != save) continue;
+            saves[i] = saves.back();
+            saves.pop_back();
+            break;
+        }
+    }
+
+    ~SaveSyncer() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        if (thread.joinable()) thread.join();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<SaveFile*> saves;
+    std::thread thread;
+    bool stopping = false;
+
+    SaveSyncer() {}
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopping) {
+            auto now = std::chrono::steady_clock::now();
+            auto next = now + std::chrono::hours(1);
+            for (SaveFile* save : saves) {
+                if (save->next_sync <= now) {
+                    save->sync();
+                    save->next_sync = now + save->interval;
+                }
+                if (save->next_sync < next) next = save->next_sync;
+            }
+            wake.wait_until(lock, next);
+        }
+    }
+};
+
+inline SaveFile::~SaveFile() {
+    if (!mapped) return;
+    SaveSyncer::shared().remove(this);
+    dirty.store(true);
+    sync();
+#ifdef _WIN32
+    UnmapViewOfFile(mapped);
+    CloseHandle(mapping);
+    CloseHandle(file);
+#else
+    munmap(mapped, length);
+    close(fd);
+#endif
+}
+
+inline std::unique_ptr<SaveFile> SaveFile::open(const std::string& path, size_t size,
+                                                std::chrono::milliseconds interval) {
+    std::unique_ptr<SaveFile> save(new SaveFile());
+    save->file_path = path;
+    save->length = size;
+    save->interval = interval;
+#ifdef _WIN32
+    save->file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (save->file == INVALID_HANDLE_VALUE) {
+        if (GetLastError() == ERROR_SHARING_VIOLATION)
+            printf("Save file in use by another instance, RAM will not be saved: %s\n", path.c_str());
+        else
+            printf("Failed to open save file: %s\n", path.c_str());
+        return nullptr;
+    }
+    LARGE_INTEGER file_size;
+    GetFileSizeEx(save->file, &file_size);
+    DWORD map_size = file_size.QuadPart < (LONGLONG)size ? (DWORD)size : 0;   // 0: whole file
+    save->mapping = CreateFileMappingA(save->file, nullptr, PAGE_READWRITE, 0, map_size, nullptr);
+    if (save->mapping)
+        save->mapped = (uint8_t*)MapViewOfFile(save->mapping, FILE_MAP_WRITE, 0, 0, size);
+    if (!save->mapped) {
+        printf("Failed to map save file: %s\n", path.c_str());
+        if (save->mapping) CloseHandle(save->mapping);
+        CloseHandle(save->file);
+        return nullptr;
+    }
+#else
+    save->fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (save->fd < 0) {
+        printf("Failed to open save file: %s\n", path.c_str());
+        return nullptr;
+    }
+    // Released when the file is closed
+    if (flock(save->fd, LOCK_EX | LOCK_NB) != 0) {
+        printf("Save file in use by another instance, RAM will not be saved: %s\n", path.c_str());
+        close(save->fd);
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(save->fd, &st) != 0 || ((size_t)st.st_size < size && ftruncate(save->fd, size) != 0)) {
+        printf("Failed to size save file: %s\n", path.c_str());
+        close(save->fd);
+        return nullptr;
+    }
+    void* mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, save->fd, 0);
+    if (mem == MAP_FAILED) {
+        printf("Failed to map save file: %s\n", path.c_str());
+        close(save->fd);
+        return nullptr;
+    }
+    save->mapped = (uint8_t*)mem;
+#endif
+    SaveSyncer::shared().add(save.get());
+    return save;
+}
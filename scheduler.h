@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+
+// Cycle-timestamped event scheduler.
+//
+// Components do not get stepped after every instruction any more. Each one
+// that has something to do at a known future T-cycle (the PPU's next mode or
+// line change, the end of the current run, ...) puts a deadline in its slot
+// here, and the CPU runs freely until `now` reaches `next`, the earliest of
+// them. The per-instruction cost is one add and one compare.
+//
+// There are only four event kinds (below), so instead of a heap each kind
+// has a fixed slot and `next` is recomputed over the slots whenever one
+// changes. Scheduling a kind that is already pending moves its deadline.
+
+enum EventType : uint8_t {
+    // PPU catch-up at its next interrupt or the end of the frame, or at every
+    // mode and line change while LY or STAT is being read. Rebooked each time
+    // it catches up early (for a read of LY/STAT or a write to VRAM, OAM or
+    // an LCD register).
+    EVENT_PPU,
+    EVENT_RUN_END,      // the cycle budget of the current run is used up
+    EVENT_INTERRUPT,    // something may have made an interrupt serviceable (or the CPU is halted)
+    EVENT_OAM_DMA,      // end of an OAM DMA transfer: OAM is accessible again
+    EVENT_COUNT
+};
+
+constexpr uint64_t EVENT_NEVER = UINT64_MAX;
+
+struct Scheduler {
+    uint64_t now = 0;                  // T-cycles since power-on
+    uint64_t next = EVENT_NEVER;       // earliest deadline in `deadline`
+    uint64_t deadline[EVENT_COUNT];
+
+    Scheduler() {
+        for (uint64_t& at : deadline) at = EVENT_NEVER;
+    }
+
+    void schedule(EventType type, uint64_t at) {
+        deadline[type] = at;
+        if (at < next) next = at;
+        else update_next();
+    }
+
+    // Fires at the next check, i.e. once the current instruction has finished
+    void schedule_now(EventType type) { schedule(type, now); }
+
+    void cancel(EventType type) {
+        deadline[type] = EVENT_NEVER;
+        update_next();
+    }
+
+    bool due(EventType type) const { return deadline[type] <= now; }
+
+    // T-cycles until the earliest event; the CPU may run this long without
+    // any component needing attention
+    uint64_t until_next() const { return next > now ? next - now : 0; }
+
+private:
+    void update_next() {
+        next = EVENT_NEVER;
+        for (uint64_t at : deadline)
+            if (at < next) next = at;
+    }
+};
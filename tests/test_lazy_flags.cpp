@@ -0,0 +1,267 @@
+// Checks lazy flags (GB_LAZY_FLAGS) against eager ones. Built with
+// GB_LAZY_FLAGS_VERIFY, every flag producer in CPU.h both records its lazy
+// op and computes F eagerly into F_eager, so one interpreter runs both.
+//
+// Every handler that reads or writes F is run over its operands, with F
+// arriving both ways a handler can find it: complete (all 16 values of
+// ZNHC) and still pending from each kind of lazy op, set up by running an
+// ALU instruction first. After that instruction and after the handler, F
+// built from the lazy state, the Z and C reads branches and carry-in use,
+// and the F that PUSH AF stores must all be the eager F. DAA is also run
+// after ADD, ADC, SUB and SBC of every pair of operands.
+//
+//   g++ -std=c++17 -O2 -I. tests/test_lazy_flags.cpp -o test_lazy_flags && ./test_lazy_flags
+#define GB_LAZY_FLAGS_VERIFY
+#include <stdio.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "interpreter.h"
+
+constexpr uint16_t SETUP = 0xC000;      // the instruction leaving F pending
+constexpr uint16_t TEST = 0xC010;       // the handler under test
+constexpr uint16_t HL_OPERAND = 0xD000; // (HL) operands
+constexpr uint16_t STACK = 0xD100;
+
+// How F reaches the handler: `f` when `opcode` is 0, else pending from
+// running `opcode` `imm` (an immediate, or a CB opcode) on A = `a`, starting
+// from F = `f`
+struct FlagInput {
+    const char* name;
+    uint8_t f;
+    uint8_t opcode, imm;
+    uint8_t a;
+};
+
+// Operands of the two-operand ALU handlers when F is pending: the nibble
+// and byte edges, where H and C flip
+const uint8_t EDGE_VALUES[] = { 0x00, 0x01, 0x07, 0x08, 0x0F, 0x10, 0x11, 0x7F, 0x80, 0x81, 0x99, 0x9A, 0xEF, 0xF0, 0xFE, 0xFF };
+
+const uint16_t WORDS[] = { 0x0000, 0x0001, 0x000F, 0x0010, 0x00FF, 0x0100, 0x07FF, 0x0800, 0x0FFF, 0x1000,
+                           0x7FFF, 0x8000, 0xF000, 0xFF00, 0xFFF0, 0xFFFF, 0x0F0F, 0xF0F0, 0x1234, 0x8888 };
+
+struct Checker {
+    std::unique_ptr<Interpreter> gb{ new Interpreter() };
+    std::vector<FlagInput> inputs;
+    uint64_t cases = 0;
+    int failures = 0;
+
+    Checker() {
+        static const char* const names[16] = { "F=00", "F=10", "F=20", "F=30", "F=40", "F=50", "F=60", "F=70",
+                                               "F=80", "F=90", "F=A0", "F=B0", "F=C0", "F=D0", "F=E0", "F=F0" };
+        for (int f = 0; f < 16; f++) inputs.push_back({ names[f], (uint8_t)(f << 4), 0, 0, 0 });
+        const FlagInput pending[] = {
+            { "ADD 00+00", 0x00, 0xC6, 0x00, 0x00 }, { "ADD 08+08", 0x00, 0xC6, 0x08, 0x08 },
+            { "ADD 80+80", 0x00, 0xC6, 0x80, 0x80 }, { "ADD FF+01", 0x00, 0xC6, 0x01, 0xFF },
+            { "ADD F8+18", 0x00, 0xC6, 0x18, 0xF8 }, { "ADD 12+34", 0xF0, 0xC6, 0x34, 0x12 },
+            { "ADC 0F+00+1", 0x10, 0xCE, 0x00, 0x0F }, { "ADC FF+00+1", 0x10, 0xCE, 0x00, 0xFF },
+            { "ADC 12+34+1", 0x10, 0xCE, 0x34, 0x12 },
+            { "SUB 00-00", 0x00, 0xD6, 0x00, 0x00 }, { "SUB 10-01", 0x00, 0xD6, 0x01, 0x10 },
+            { "SUB 00-01", 0x00, 0xD6, 0x01, 0x00 }, { "SUB 10-20", 0x00, 0xD6, 0x20, 0x10 },
+            { "SUB 05-03", 0xF0, 0xD6, 0x03, 0x05 },
+            { "SBC 00-00-1", 0x10, 0xDE, 0x00, 0x00 }, { "SBC 01-00-1", 0x10, 0xDE, 0x00, 0x01 },
+            { "CP 42-42", 0x00, 0xFE, 0x42, 0x42 }, { "CP 10-20", 0x00, 0xFE, 0x20, 0x10 },
+            { "AND F0&0F", 0x10, 0xE6, 0x0F, 0xF0 }, { "AND FF&0F", 0x00, 0xE6, 0x0F, 0xFF },
+            { "XOR 55^55", 0x10, 0xEE, 0x55, 0x55 }, { "OR 00|00", 0x10, 0xF6, 0x00, 0x00 },
+            { "OR 01|00", 0x00, 0xF6, 0x00, 0x01 },
+            { "INC FF", 0x00, 0x3C, 0, 0xFF }, { "INC 0F C", 0x10, 0x3C, 0, 0x0F },
+            { "INC 01 C", 0x10, 0x3C, 0, 0x01 },
+            { "DEC 01", 0x00, 0x3D, 0, 0x01 }, { "DEC 10 C", 0x10, 0x3D, 0, 0x10 },
+            { "DEC 00 C", 0x10, 0x3D, 0, 0x00 },
+            { "RL 80", 0x00, 0xCB, 0x17, 0x80 }, { "SWAP 00 C", 0x10, 0xCB, 0x37, 0x00 },
+            { "BIT 7,00 C", 0x10, 0xCB, 0x7F, 0x00 },
+        };
+        for (const FlagInput& input : pending) inputs.push_back(input);
+    }
+
+    void step() {
+        uint8_t opcode = gb->fetch_opcode();
+        (gb.get()->*Interpreter::opcode_handlers[opcode])(opcode);
+    }
+
+    // Sets up F; false if it already came out wrong
+    bool set_flags(const FlagInput& input) {
+        CPU& cpu = gb->cpu;
+        cpu.setF(input.f);
+        if (!input.opcode) return true;
+        cpu.A = input.a;
+        gb->memory.write(SETUP, input.opcode);
+        gb->memory.write(SETUP + 1, input.imm);
+        cpu.PC = SETUP;
+        step();
+        return compare(input, "setup", 0, 0);
+    }
+
+    // 8-bit register operand as encoded in opcode bits: B C D E H L (HL) A
+    void set_operand(int r, uint8_t value) {
+        CPU& cpu = gb->cpu;
+        switch (r) {
+        case 0: cpu.B = value; break;
+        case 1: cpu.C = value; break;
+        case 2: cpu.D = value; break;
+        case 3: cpu.E = value; break;
+        case 4: cpu.H = value; break;
+        case 5: cpu.L = value; break;
+        case 6: cpu.setHL(HL_OPERAND); gb->memory.write(HL_OPERAND, value); break;
+        default: cpu.A = value; break;
+        }
+    }
+
+    bool compare(const FlagInput& input, const char* what, uint8_t a, uint16_t operand) {
+        const CPU& cpu = gb->cpu;
+        uint8_t eager = cpu.F_eager;
+        cases++;
+        if (cpu.peekF() == eager && cpu.getFlagZ() == ((eager & 0x80) != 0) && cpu.getFlagC() == ((eager & 0x10) != 0))
+            return true;
+        if (failures++ < 10)
+            printf("FAIL %s, A %02X operand %04X, F from %s: lazy %02X (Z %d C %d), eager %02X\n",
+                what, a, operand, input.name, cpu.peekF(), cpu.getFlagZ(), cpu.getFlagC(), eager);
+        return false;
+    }
+
+    // Runs the instruction at TEST once F has been set up and the operands
+    // stored by `load`
+    template <typename Load>
+    void run(const FlagInput& input, const char* what, uint8_t a, uint16_t operand, Load load) {
+        if (!set_flags(input)) return;
+        load();
+        gb->cpu.PC = TEST;
+        step();
+        compare(input, what, a, operand);
+    }
+
+    void code(uint8_t first, uint8_t second = 0) {
+        gb->memory.write(TEST, first);
+        gb->memory.write(TEST + 1, second);
+    }
+
+    // ADD ADC SUB SBC AND XOR OR CP, A,r and A,d8: every pair of operands
+    // for complete F, the edge values for pending F
+    void alu() {
+        static const uint8_t d8_opcodes[] = { 0xC6, 0xCE, 0xD6, 0xDE, 0xE6, 0xEE, 0xF6, 0xFE };
+        for (int k = 0; k < 64 + 8; k++) {
+            uint8_t opcode = k < 64 ? 0x80 + k : d8_opcodes[k - 64];
+            int src = k < 64 ? r8_src(opcode) : -1;
+            char what[16];
+            snprintf(what, sizeof(what), "op %02X", opcode);
+            for (const FlagInput& input : inputs) {
+                int values = input.opcode ? (int)sizeof(EDGE_VALUES) : 256;
+                for (int i = 0; i < values; i++) {
+                    uint8_t value = input.opcode ? EDGE_VALUES[i] : (uint8_t)i;
+                    if (src == 7) {
+                        code(opcode);
+                        run(input, what, value, value, [&] { gb->cpu.A = value; });
+                        continue;
+                    }
+                    for (int a = 0; a < 256; a++) {
+                        if (src < 0) code(opcode, value);
+                        else code(opcode);
+                        run(input, what, (uint8_t)a, value, [&] { gb->cpu.A = (uint8_t)a; if (src >= 0) set_operand(src, value); });
+                    }
+                }
+            }
+        }
+    }
+
+    // INC/DEC r, the accumulator rotates, DAA CPL SCF CCF, every CB opcode,
+    // PUSH AF and POP AF, each over all 256 operand values
+    void single_operand() {
+        std::vector<uint16_t> opcodes;
+        for (int r = 0; r < 8; r++) { opcodes.push_back(0x04 + r * 8); opcodes.push_back(0x05 + r * 8); }
+        for (uint8_t opcode : { 0x07, 0x0F, 0x17, 0x1F, 0x27, 0x2F, 0x37, 0x3F, 0xF5, 0xF1 }) opcodes.push_back(opcode);
+        for (int cb = 0; cb < 256; cb++) opcodes.push_back(0xCB00 | cb);
+
+        for (uint16_t opcode : opcodes) {
+            bool cb = opcode > 0xFF;
+            int r = cb ? r8_src((uint8_t)opcode) : opcode < 0x40 && (opcode & 7) >= 4 && (opcode & 7) <= 5 ? r8_dst((uint8_t)opcode) : 7;
+            char what[16];
+            snprintf(what, sizeof(what), cb ? "op CB %02X" : "op %02X", opcode & 0xFF);
+            for (const FlagInput& input : inputs) {
+                for (int value = 0; value < 256; value++) {
+                    if (cb) code(0xCB, (uint8_t)opcode);
+                    else code((uint8_t)opcode);
+                    CPU& cpu = gb->cpu;
+                    if (opcode == 0xF1) {
+                        // POP AF: F is whatever was on the stack, low nibble dropped
+                        run(input, what, 0x12, value, [&] {
+                            cpu.STACK_P = STACK;
+                            gb->memory.write(STACK, (uint8_t)value);
+                            gb->memory.write(STACK + 1, 0x12);
+                        });
+                        if (cpu.F_eager != (value & 0xF0) && failures++ < 10)
+                            printf("FAIL POP AF of %02X: F %02X\n", value, cpu.F_eager);
+                        continue;
+                    }
+                    run(input, what, (uint8_t)value, value, [&] { cpu.STACK_P = STACK; set_operand(r, (uint8_t)value); });
+                    if (opcode == 0xF5 && gb->memory.read(STACK - 2) != cpu.F_eager && failures++ < 10)
+                        printf("FAIL PUSH AF, F from %s: pushed %02X, eager %02X\n", input.name, gb->memory.read(STACK - 2), cpu.F_eager);
+                }
+            }
+        }
+    }
+
+    // ADD HL,rr; ADD SP,r8 and LD HL,SP+r8
+    void sixteen_bit() {
+        for (const FlagInput& input : inputs) {
+            for (int rr = 0; rr < 4; rr++) {
+                char what[16];
+                snprintf(what, sizeof(what), "op %02X", 0x09 + rr * 16);
+                for (uint16_t hl : WORDS)
+                    for (uint16_t value : WORDS) {
+                        code(0x09 + rr * 16);
+                        run(input, what, 0, value, [&] {
+                            CPU& cpu = gb->cpu;
+                            if (rr == 0) cpu.setBC(value);
+                            else if (rr == 1) cpu.setDE(value);
+                            else if (rr == 3) cpu.STACK_P = value;
+                            cpu.setHL(rr == 2 ? value : hl);
+                        });
+                    }
+            }
+            for (uint8_t opcode : { 0xE8, 0xF8 }) {
+                char what[16];
+                snprintf(what, sizeof(what), "op %02X", opcode);
+                for (uint16_t sp : WORDS)
+                    for (int offset = 0; offset < 256; offset++) {
+                        code(opcode, (uint8_t)offset);
+                        run(input, what, 0, sp, [&] { gb->cpu.STACK_P = sp; });
+                    }
+            }
+        }
+    }
+
+    // DAA straight after ADD, ADC, SUB or SBC A,B of every pair of operands,
+    // with the carry in both set and clear
+    void daa() {
+        static const FlagInput from[4] = {
+            { "ADD A,B", 0, 0x80, 0, 0 }, { "ADC A,B", 0, 0x88, 0, 0 },
+            { "SUB B", 0, 0x90, 0, 0 }, { "SBC A,B", 0, 0x98, 0, 0 },
+        };
+        for (const FlagInput& op : from)
+            for (uint8_t f : { 0x00, 0xF0 })
+                for (int a = 0; a < 256; a++)
+                    for (int b = 0; b < 256; b++) {
+                        FlagInput input = op;
+                        input.f = f;
+                        input.a = (uint8_t)a;
+                        gb->cpu.B = (uint8_t)b;
+                        code(0x27);
+                        run(input, "DAA", (uint8_t)a, b, [] {});
+                    }
+    }
+};
+
+int main() {
+    Checker checker;
+    checker.alu();
+    printf("ALU: checked\n");
+    checker.single_operand();
+    printf("INC/DEC, rotates, DAA/CPL/SCF/CCF, CB, PUSH/POP AF: checked\n");
+    checker.sixteen_bit();
+    printf("16-bit ALU: checked\n");
+    checker.daa();
+    printf("DAA after ADD/SUB: checked\n");
+
+    printf("%llu cases, %d failures\n", (unsigned long long)checker.cases, checker.failures);
+    return checker.failures ? 1 : 0;
+}
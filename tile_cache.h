@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include "vram_index.h"
+
+constexpr int TILE_COUNT = 384;     // 8000-97FF, 16 bytes each
+
+// All 384 VRAM tiles decoded to 8x8 color numbers (0-3, leftmost pixel
+// first), plus horizontally flipped copies for sprites. A CPU write to tile
+// data sets the row's bit in VramIndex::tile_dirty; the row is decoded again
+// the next time the renderer asks for it, so tiles that do not change are
+// decoded once however many frames draw them.
+struct TileCache {
+    VramIndex& vram;
+    uint8_t pixels[TILE_COUNT][8][8];
+    uint8_t flipped[TILE_COUNT][8][8];
+
+    uint64_t hits = 0;          // rows served without decoding
+    uint64_t decodes = 0;       // rows decoded after a VRAM write
+
+    explicit TileCache(VramIndex& vram) : vram(vram) {}
+    TileCache(const TileCache&) = delete;
+    TileCache& operator=(const TileCache&) = delete;
+
+    // Tile a background/window map entry refers to. Unsigned indices reach
+    // tiles 0-255 from 0x8000; signed ones are based at 0x9000 and reach
+    // tiles 128-383.
+    static int tile_number(uint8_t index, bool signed_index) {
+        int tile_addr = signed_index ? 0x9000 + (int8_t)index * 16 : 0x8000 + index * 16;
+        return (tile_addr - 0x8000) >> 4;
+    }
+
+    // Color numbers of one row of a tile, `flip` for the mirrored row
+    const uint8_t* row(int tile, int line, bool flip = false) {
+        uint8_t& dirty = vram.tile_dirty[tile];
+        if (dirty & (1 << line)) {
+            decode(tile, line);
+            dirty &= ~(1 << line);
+            decodes++;
+        }
+        else {
+            hits++;
+        }
+        return flip ? flipped[tile][line] : pixels[tile][line];
+    }
+
+private:
+    void decode(int tile, int line) {
+        const uint8_t* bytes = vram.bytes + tile * 16 + line * 2;
+        uint8_t* out = pixels[tile][line];
+        uint8_t* out_flipped = flipped[tile][line];
+        for (int x = 0; x < 8; x++) {
+            int bit = 7 - x;
+            uint8_t color = ((bytes[1] >> bit) & 1) << 1 | ((bytes[0] >> bit) & 1);
+            out[x] = color;
+            out_flipped[7 - x] = color;
+        }
+    }
+};
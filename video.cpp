@@ -1,5 +1,4 @@
 ﻿#include "video.h"
-#include <vector>
 
 SDL_Window* window = nullptr;
 SDL_Renderer* renderer = nullptr;
@@ -18,18 +17,25 @@ void init_video() {
         SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
-void render_frame(const uint8_t framebuffer[144][160]) {
-    std::vector<uint32_t> pixels(144 * 160);
+static bool locked = false;
 
-    for (int y = 0; y < 144; y++) {
-        for (int x = 0; x < 160; x++) {
-            uint8_t color = framebuffer[y][x];
-            uint8_t brightness = 255 - color * 85;
-            pixels[y * 160 + x] = (brightness << 16) | (brightness << 8) | brightness;
-        }
-    }
+uint32_t* begin_frame(int* pitch) {
+    void* pixels = nullptr;
+    int bytes = 0;
+    if (!texture || !SDL_LockTexture(texture, NULL, &pixels, &bytes)) return nullptr;
+    locked = true;
+    *pitch = bytes / (int)sizeof(uint32_t);
+    return (uint32_t*)pixels;
+}
 
-    SDL_UpdateTexture(texture, NULL, pixels.data(), 160 * sizeof(uint32_t));
+void present_frame(const uint32_t* pixels, int pitch) {
+    if (locked) {
+        SDL_UnlockTexture(texture);
+        locked = false;
+    }
+    else {
+        SDL_UpdateTexture(texture, NULL, pixels, pitch * (int)sizeof(uint32_t));
+    }
 
     SDL_RenderClear(renderer);
     SDL_RenderTexture(renderer, texture, NULL, NULL);  // ✅ SDL3 correct
@@ -37,6 +43,7 @@ void render_frame(const uint8_t framebuffer[144][160]) {
 }
 
 void cleanup_video() {
+    if (locked) SDL_UnlockTexture(texture);
     if (texture) SDL_DestroyTexture(texture);
     if (renderer) SDL_DestroyRenderer(renderer);
     if (window) SDL_DestroyWindow(window);
@@ -10,5 +10,10 @@ extern SDL_Renderer* renderer;
 extern SDL_Texture* texture;
 
 void init_video();
-void render_frame(const uint8_t framebuffer[144][160]);
+// Locks the texture and returns its pixels for the next frame to be drawn
+// into (XRGB8888, `pitch` in pixels). Null if it cannot be locked.
+uint32_t* begin_frame(int* pitch);
+// Shows the frame: unlocks the texture, or uploads `pixels` into it when
+// the frame was drawn somewhere else
+void present_frame(const uint32_t* pixels, int pitch);
 void cleanup_video();
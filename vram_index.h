@@ -0,0 +1,97 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// One CPU write to VRAM, as the render thread replays it (see render_thread.h)
+struct VramWrite {
+    uint16_t addr;
+    uint8_t value;
+};
+
+// VRAM (8000-9FFF) together with what the PPU's tile cache and map layers
+// must draw again since they last looked at it. Memory keeps one over its
+// own VRAM; the render thread keeps one over its copy.
+struct VramIndex {
+    uint8_t* bytes;     // 0x2000 bytes, 8000 first
+
+    // One bit per row of each tile (8000-97FF), set by writes to it and
+    // cleared by the tile cache once it has decoded the row again
+    uint8_t tile_dirty[384];
+
+    // Tile map (9800-9BFF, 9C00-9FFF) entries the map layers must draw
+    // again: bit e of map_dirty[map][y] covers entry e of the map row under
+    // pixel line y. Set by writes to the entry, and by writes to tile data
+    // for all of every line whose map row holds an index that can refer to
+    // the tile. map_uses/map_rows find those rows: per map row, how many
+    // entries hold each index, and per index, the rows holding it.
+    uint32_t map_dirty[2][256];
+    uint8_t map_uses[2][32][256];
+    uint32_t map_rows[2][256];
+
+    explicit VramIndex(uint8_t* bytes) : bytes(bytes) { reindex(); }
+    VramIndex(const VramIndex&) = delete;
+    VramIndex& operator=(const VramIndex&) = delete;
+
+    // Rebuilds the map index from VRAM and marks everything dirty, for when
+    // VRAM has changed behind the index's back
+    void reindex() {
+        memset(tile_dirty, 0xFF, sizeof(tile_dirty));
+        memset(map_uses, 0, sizeof(map_uses));
+        memset(map_rows, 0, sizeof(map_rows));
+        memset(map_dirty, 0xFF, sizeof(map_dirty));
+        for (int map = 0; map < 2; map++)
+            for (int entry = 0; entry < 0x400; entry++) {
+                uint8_t index = bytes[0x1800 + map * 0x400 + entry];
+                map_uses[map][entry >> 5][index]++;
+                map_rows[map][index] |= 1u << (entry >> 5);
+            }
+    }
+
+    // Stores a byte and marks what it changes
+    void write(uint16_t addr, uint8_t value) {
+        if (addr < 0x9800) write_tile_data(addr, value);
+        else write_tile_map(addr, value);
+    }
+
+    // Index of the lowest set bit
+    static int lowest_bit(uint64_t mask) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, mask);
+        return (int)index;
+#else
+        return __builtin_ctzll(mask);
+#endif
+    }
+
+private:
+    void write_tile_data(uint16_t addr, uint8_t value) {
+        bytes[addr - 0x8000] = value;
+        int tile = (addr - 0x8000) >> 4, line = (addr >> 1) & 7;
+        tile_dirty[tile] |= 1 << line;
+        // Map entries reach tiles 0-255 unsigned, as index `tile`, and tiles
+        // 128-383 signed (based at 0x9000), as index `tile - 256`
+        uint8_t indices[2];
+        int count = 0;
+        if (tile < 256) indices[count++] = (uint8_t)tile;
+        if (tile >= 128) indices[count++] = (uint8_t)(tile - 256);
+        for (int map = 0; map < 2; map++)
+            for (int i = 0; i < count; i++)
+                for (uint32_t rows = map_rows[map][indices[i]]; rows; rows &= rows - 1)
+                    map_dirty[map][lowest_bit(rows) * 8 + line] = ~0u;
+    }
+
+    void write_tile_map(uint16_t addr, uint8_t value) {
+        uint8_t& stored = bytes[addr - 0x8000];
+        uint8_t old = stored;
+        stored = value;
+        if (old == value) return;
+        int map = (addr >> 10) & 1, row = (addr >> 5) & 31, column = addr & 31;
+        if (--map_uses[map][row][old] == 0) map_rows[map][old] &= ~(1u << row);
+        if (map_uses[map][row][value]++ == 0) map_rows[map][value] |= 1u << row;
+        for (int line = 0; line < 8; line++) map_dirty[map][row * 8 + line] |= 1u << column;
+    }
+};